@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    FFT band analysis, moved off the audio thread.
+
+  ==============================================================================
+*/
+
+#include "AnalysisEngine.h"
+
+//==============================================================================
+AnalysisEngine::AnalysisEngine()
+    : juce::Thread("XYscope analysis")
+{
+}
+
+AnalysisEngine::~AnalysisEngine()
+{
+    stopThread(1000);
+}
+
+//==============================================================================
+void AnalysisEngine::setSource(const ScopeRing* ring)
+{
+    const juce::ScopedLock sl(configLock);
+    stopThread(1000);
+
+    source = ring;
+
+    const auto capacity = ring != nullptr ? (size_t)ring->getCapacity() : 0;
+    sourceL.resize(capacity);
+    sourceR.resize(capacity);
+    mono.resize(capacity);
+
+    sourceChannels.assign(ring != nullptr ? (size_t)ring->getNumChannels() : 0, nullptr);
+
+    if (ring != nullptr)
+    {
+        sourceChannels[0] = sourceL.data();
+        sourceChannels[1] = sourceR.data();
+    }
+
+    startIfReady();
+}
+
+void AnalysisEngine::prepare(double sampleRate)
+{
+    const juce::ScopedLock sl(configLock);
+    stopThread(1000);
+
+    if (sampleRate <= 0.0)
+        sampleRate = 44100.0;
+
+    // Keep bin spacing under ~48 Hz whatever the host rate is:
+    // 1024 points at 44.1/48 kHz, 2048 at 88.2/96 kHz, 4096 at 176.4/192 kHz.
+    fftOrder = 10;
+    while (sampleRate / (double)(1 << fftOrder) > 48.0 && fftOrder < 13)
+        ++fftOrder;
+
+    fftSize = 1 << fftOrder;
+    fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+    window.resize((size_t)fftSize);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+
+    history.assign((size_t)fftSize, 0.0f);
+    fftData.assign((size_t)fftSize * 2, 0.0f);
+    samplesSinceLastWindow = 0;
+
+    // Band edges from the real sample rate. Bin 0 is DC and belongs to no band.
+    const int nyquistBin = fftSize / 2;
+    auto binForHz = [&](double hz)
+        {
+            return juce::jlimit(1, nyquistBin, juce::roundToInt(hz * (double)fftSize / sampleRate));
+        };
+
+    bassStart = 1;
+    bassEnd = juce::jlimit(bassStart + 1, nyquistBin - 2, binForHz(bassUpperHz));
+    midEnd = juce::jlimit(bassEnd + 1, nyquistBin - 1, binForHz(midUpperHz));
+    highEnd = nyquistBin;
+
+    prepared = true;
+    startIfReady();
+}
+
+void AnalysisEngine::release()
+{
+    const juce::ScopedLock sl(configLock);
+    stopThread(1000);
+    prepared = false;
+}
+
+void AnalysisEngine::startIfReady()
+{
+    if (! prepared || source == nullptr)
+        return;
+
+    cursor = source->getWritePosition();
+    samplesSinceLastWindow = 0;
+    publish({});
+
+    if (! offline)
+        startThread(juce::Thread::Priority::low);
+}
+
+void AnalysisEngine::setOffline(bool shouldBeOffline)
+{
+    const juce::ScopedLock sl(configLock);
+    stopThread(1000);
+
+    offline = shouldBeOffline;
+    startIfReady();
+}
+
+void AnalysisEngine::update()
+{
+    const juce::ScopedLock sl(configLock);
+    jassert(offline);
+
+    if (offline && prepared && source != nullptr)
+        followSource();
+}
+
+void AnalysisEngine::setOverlap(float overlapFraction) noexcept
+{
+    overlap.store(juce::jlimit(0.0f, 0.875f, overlapFraction));
+}
+
+int AnalysisEngine::getHopSize() const noexcept
+{
+    return juce::jmax(fftSize / 8, juce::roundToInt((float)fftSize * (1.0f - overlap.load())));
+}
+
+//==============================================================================
+BandEnergies AnalysisEngine::getBandEnergies() const noexcept
+{
+    for (;;)
+    {
+        const auto before = sequence.load(std::memory_order_acquire);
+
+        if ((before & 1u) == 0)
+        {
+            BandEnergies energies;
+            energies.bass = publishedBass.load(std::memory_order_relaxed);
+            energies.mid = publishedMid.load(std::memory_order_relaxed);
+            energies.high = publishedHigh.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return energies;
+        }
+
+        juce::Thread::yield();
+    }
+}
+
+void AnalysisEngine::publish(const BandEnergies& energies) noexcept
+{
+    const auto seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    publishedBass.store(energies.bass, std::memory_order_relaxed);
+    publishedMid.store(energies.mid, std::memory_order_relaxed);
+    publishedHigh.store(energies.high, std::memory_order_relaxed);
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+//==============================================================================
+void AnalysisEngine::run()
+{
+    jassert(source != nullptr);
+
+    while (! threadShouldExit())
+    {
+        followSource();
+        wait(pollIntervalMs);
+    }
+}
+
+void AnalysisEngine::followSource()
+{
+    if (! active.load(std::memory_order_relaxed))
+    {
+        cursor = source->getWritePosition();
+        return;
+    }
+
+    const int num = source->read(cursor, sourceChannels.data(), (int)mono.size());
+
+    if (num > 0)
+    {
+        // Mono = (L + R) / 2
+        juce::FloatVectorOperations::add(mono.data(), sourceL.data(), sourceR.data(), num);
+        juce::FloatVectorOperations::multiply(mono.data(), 0.5f, num);
+        consume(mono.data(), num, getHopSize());
+    }
+}
+
+void AnalysisEngine::consume(const float* samples, int numSamples, int hopSize)
+{
+    while (numSamples > 0)
+    {
+        const int take = juce::jmin(numSamples, juce::jmax(1, hopSize - samplesSinceLastWindow));
+
+        // Slide the history window along and append the new samples
+        std::memmove(history.data(), history.data() + take, (size_t)(fftSize - take) * sizeof(float));
+        std::memcpy(history.data() + fftSize - take, samples, (size_t)take * sizeof(float));
+
+        samples += take;
+        numSamples -= take;
+        samplesSinceLastWindow += take;
+
+        if (samplesSinceLastWindow >= hopSize)
+        {
+            analyseWindow();
+            samplesSinceLastWindow = 0;
+        }
+    }
+}
+
+void AnalysisEngine::analyseWindow()
+{
+    juce::FloatVectorOperations::multiply(fftData.data(), history.data(), window.data(), fftSize);
+    juce::FloatVectorOperations::clear(fftData.data() + fftSize, fftSize);
+
+    fft->performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // Hann coherent gain is 0.5, and magnitudes grow with the FFT size, so
+    // rescale to the levels the colour mapping was tuned for (1024 points,
+    // rectangular window, * 0.1).
+    const float scale = 2.0f * (1024.0f / (float)fftSize) * 0.1f;
+
+    auto bandLevel = [&](int start, int end)
+        {
+            const float average = sumBins(fftData.data() + start, end - start) / (float)(end - start);
+            return juce::jlimit(0.0f, 1.0f, average * scale);
+        };
+
+    BandEnergies energies;
+    energies.bass = bandLevel(bassStart, bassEnd);
+    energies.mid = bandLevel(bassEnd, midEnd);
+    energies.high = bandLevel(midEnd, highEnd);
+
+    publish(energies);
+}
+
+float AnalysisEngine::sumBins(const float* bins, int numBins) noexcept
+{
+    float total = 0.0f;
+    int i = 0;
+
+   #if JUCE_USE_SIMD
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = (int)Vec::SIMDNumElements;
+
+    // Scalar head until the loads are aligned
+    while (i < numBins && ! Vec::isSIMDAligned(bins + i))
+        total += bins[i++];
+
+    auto acc = Vec::expand(0.0f);
+    for (; i + lanes <= numBins; i += lanes)
+        acc += Vec::fromRawArray(bins + i);
+
+    total += acc.sum();
+   #endif
+
+    for (; i < numBins; ++i)
+        total += bins[i];
+
+    return total;
+}
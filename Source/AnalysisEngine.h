@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScopeRing.h"
+
+//==============================================================================
+// Bass/mid/high energies from one FFT frame. Always published and read as a
+// single snapshot so the three values can never come from different frames.
+struct BandEnergies
+{
+    float bass = 0.0f;
+    float mid = 0.0f;
+    float high = 0.0f;
+};
+
+//==============================================================================
+// Runs the FFT band analysis on its own worker thread.
+//
+// The worker follows the scope ring with its own read cursor, so the audio
+// thread does no analysis work at all. It applies a Hann window with
+// configurable overlap and publishes the band energies as one consistent
+// snapshot for the editor.
+class AnalysisEngine : private juce::Thread
+{
+public:
+    AnalysisEngine();
+    ~AnalysisEngine() override;
+
+    // Not realtime safe. The worker only runs while the engine is prepared
+    // and has a ring to follow; channels 0 and 1 of the ring must be left and
+    // right. Pass nullptr before the ring is destroyed.
+    void setSource(const ScopeRing* ring);
+
+    // Not realtime safe: picks the FFT size and band edges for the sample rate
+    // and (re)starts the worker. Call from prepareToPlay.
+    void prepare(double sampleRate);
+    void release();
+
+    // Fraction of each window shared with the next one, 0 .. 0.875.
+    void setOverlap(float overlapFraction) noexcept;
+
+    // Samples from one window's start to the next's, for the prepared FFT
+    // size and the current overlap; at least an eighth of a window.
+    int getHopSize() const noexcept;
+
+    // Any thread. While inactive the worker only keeps its cursor current.
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive, std::memory_order_relaxed); }
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    // Any thread. Returns the most recently completed frame.
+    BandEnergies getBandEnergies() const noexcept;
+
+    // Not realtime safe. Offline, the worker doesn't run and update() does its
+    // work instead, on the caller's thread: an offline renderer calls it once
+    // per frame so the bands don't depend on how threads were scheduled.
+    void setOffline(bool shouldBeOffline);
+    void update();
+
+    static constexpr double bassUpperHz = 250.0;
+    static constexpr double midUpperHz = 2000.0;
+
+private:
+    void run() override;
+    void followSource();
+    void consume(const float* samples, int numSamples, int hopSize);
+    void analyseWindow();
+    void publish(const BandEnergies& energies) noexcept;
+
+    static float sumBins(const float* bins, int numBins) noexcept;
+
+    static constexpr int pollIntervalMs = 5;
+
+    void startIfReady();
+
+    juce::CriticalSection configLock;
+    bool prepared = false;
+    bool offline = false;
+
+    const ScopeRing* source = nullptr;
+    juce::uint64 cursor = 0;
+    std::vector<float> sourceL, sourceR, mono;
+    std::vector<float*> sourceChannels;
+    std::atomic<bool> active{ false };
+
+    int fftOrder = 10;
+    int fftSize = 1 << 10;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window;
+    std::vector<float> history;   // last fftSize input samples
+    std::vector<float> fftData;   // 2 * fftSize, as required by juce::dsp::FFT
+    int samplesSinceLastWindow = 0;
+
+    int bassStart = 1, bassEnd = 1, midEnd = 1, highEnd = 1;
+
+    std::atomic<float> overlap{ 0.5f };
+
+    // Seqlock around the published snapshot: odd while the worker writes.
+    std::atomic<juce::uint32> sequence{ 0 };
+    std::atomic<float> publishedBass{ 0.0f };
+    std::atomic<float> publishedMid{ 0.0f };
+    std::atomic<float> publishedHigh{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisEngine)
+};
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    Per-sample bass/mid/high envelopes for the crossover colour mode.
+
+  ==============================================================================
+*/
+
+#include "CrossoverFilterbank.h"
+
+namespace
+{
+    // Rectified LR bands of a full-scale sine average ~0.64, scale that to ~1
+    constexpr float envelopeGain = 1.5f;
+
+    enum Lane { bassLane = 0, midLane = 1, highLane = 2 };
+}
+
+//==============================================================================
+CrossoverFilterbank::CrossoverFilterbank()
+{
+    prepare(44100.0);
+}
+
+void CrossoverFilterbank::prepare(double sampleRate)
+{
+    if (sampleRate <= 0.0)
+        sampleRate = 44100.0;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        for (int lane = 0; lane < maxLanes; ++lane)
+            setStage(stage, lane, Response::bypass, 1000.0, sampleRate);
+
+    // LR4 = two cascaded Butterworth (Q = 1/sqrt 2) stages
+    setStage(0, bassLane, Response::lowPass, bassUpperHz, sampleRate);
+    setStage(1, bassLane, Response::lowPass, bassUpperHz, sampleRate);
+
+    setStage(0, midLane, Response::highPass, bassUpperHz, sampleRate);
+    setStage(1, midLane, Response::highPass, bassUpperHz, sampleRate);
+    setStage(2, midLane, Response::lowPass, midUpperHz, sampleRate);
+    setStage(3, midLane, Response::lowPass, midUpperHz, sampleRate);
+
+    setStage(0, highLane, Response::highPass, midUpperHz, sampleRate);
+    setStage(1, highLane, Response::highPass, midUpperHz, sampleRate);
+
+    envelopeCoeff = (float)(1.0 - std::exp(-1.0 / (envelopeMs * 0.001 * sampleRate)));
+
+    reset();
+}
+
+void CrossoverFilterbank::reset() noexcept
+{
+    for (auto& stage : stages)
+    {
+        std::fill(std::begin(stage.ic1), std::end(stage.ic1), 0.0f);
+        std::fill(std::begin(stage.ic2), std::end(stage.ic2), 0.0f);
+    }
+
+    std::fill(std::begin(envelope), std::end(envelope), 0.0f);
+}
+
+void CrossoverFilterbank::setStage(int stage, int lane, Response response, double cutoffHz, double sampleRate) noexcept
+{
+    auto& s = stages[stage];
+
+    const double g = std::tan(juce::MathConstants<double>::pi * juce::jmin(cutoffHz, sampleRate * 0.45) / sampleRate);
+    const double k = juce::MathConstants<double>::sqrt2;
+    const double a1 = 1.0 / (1.0 + g * (g + k));
+
+    s.a1[lane] = (float)a1;
+    s.a2[lane] = (float)(g * a1);
+    s.a3[lane] = (float)(g * g * a1);
+    s.k[lane] = (float)k;
+
+    s.mixLow[lane] = response == Response::lowPass ? 1.0f : 0.0f;
+    s.mixHigh[lane] = response == Response::highPass ? 1.0f : 0.0f;
+    s.mixDry[lane] = response == Response::bypass ? 1.0f : 0.0f;
+}
+
+//==============================================================================
+void CrossoverFilterbank::process(const float* mono, float* bass, float* mid, float* high, int numSamples) noexcept
+{
+   #if JUCE_USE_SIMD
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static_assert(Vec::SIMDNumElements >= 3 && Vec::SIMDNumElements <= maxLanes, "need one lane per band");
+
+    // Keep coefficients and state in registers for the whole block
+    Vec a1[numStages], a2[numStages], a3[numStages], k[numStages];
+    Vec mixLow[numStages], mixHigh[numStages], mixDry[numStages];
+    Vec ic1[numStages], ic2[numStages];
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        a1[s] = Vec::fromRawArray(stages[s].a1);
+        a2[s] = Vec::fromRawArray(stages[s].a2);
+        a3[s] = Vec::fromRawArray(stages[s].a3);
+        k[s] = Vec::fromRawArray(stages[s].k);
+        mixLow[s] = Vec::fromRawArray(stages[s].mixLow);
+        mixHigh[s] = Vec::fromRawArray(stages[s].mixHigh);
+        mixDry[s] = Vec::fromRawArray(stages[s].mixDry);
+        ic1[s] = Vec::fromRawArray(stages[s].ic1);
+        ic2[s] = Vec::fromRawArray(stages[s].ic2);
+    }
+
+    auto env = Vec::fromRawArray(envelope);
+    const auto coeff = Vec::expand(envelopeCoeff);
+    const auto zero = Vec::expand(0.0f);
+    alignas(32) float out[maxLanes];
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        auto x = Vec::expand(mono[n]);
+
+        for (int s = 0; s < numStages; ++s)
+        {
+            const auto v3 = x - ic2[s];
+            const auto v1 = a1[s] * ic1[s] + a2[s] * v3;
+            const auto v2 = ic2[s] + a2[s] * ic1[s] + a3[s] * v3;
+            ic1[s] = v1 + v1 - ic1[s];
+            ic2[s] = v2 + v2 - ic2[s];
+
+            const auto hp = x - k[s] * v1 - v2;
+            x = mixLow[s] * v2 + mixHigh[s] * hp + mixDry[s] * x;
+        }
+
+        const auto rectified = Vec::max(x, zero - x);
+        env += coeff * (rectified - env);
+
+        env.copyToRawArray(out);
+        bass[n] = out[bassLane] * envelopeGain;
+        mid[n] = out[midLane] * envelopeGain;
+        high[n] = out[highLane] * envelopeGain;
+    }
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        ic1[s].copyToRawArray(stages[s].ic1);
+        ic2[s].copyToRawArray(stages[s].ic2);
+    }
+
+    env.copyToRawArray(envelope);
+   #else
+    for (int n = 0; n < numSamples; ++n)
+    {
+        float out[3];
+
+        for (int lane = 0; lane < 3; ++lane)
+        {
+            float x = mono[n];
+
+            for (auto& s : stages)
+            {
+                const float v3 = x - s.ic2[lane];
+                const float v1 = s.a1[lane] * s.ic1[lane] + s.a2[lane] * v3;
+                const float v2 = s.ic2[lane] + s.a2[lane] * s.ic1[lane] + s.a3[lane] * v3;
+                s.ic1[lane] = 2.0f * v1 - s.ic1[lane];
+                s.ic2[lane] = 2.0f * v2 - s.ic2[lane];
+
+                const float hp = x - s.k[lane] * v1 - v2;
+                x = s.mixLow[lane] * v2 + s.mixHigh[lane] * hp + s.mixDry[lane] * x;
+            }
+
+            envelope[lane] += envelopeCoeff * (std::abs(x) - envelope[lane]);
+            out[lane] = envelope[lane] * envelopeGain;
+        }
+
+        bass[n] = out[bassLane];
+        mid[n] = out[midLane];
+        high[n] = out[highLane];
+    }
+   #endif
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Splits a mono signal into bass/mid/high envelopes, one value per sample.
+//
+// Three Linkwitz-Riley paths run side by side in the lanes of one SIMD
+// register: lane 0 is LR4 low-pass at the bass edge, lane 1 is LR4 high-pass
+// at the bass edge followed by LR4 low-pass at the mid edge, and lane 2 is
+// LR4 high-pass at the mid edge. Each path is four TPT state-variable stages
+// (two for the bass and high lanes, padded with pass-through stages), so one
+// set of vector ops per stage advances all bands at once.
+class CrossoverFilterbank
+{
+public:
+    CrossoverFilterbank();
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Audio thread. Writes rectified, smoothed band envelopes roughly in the
+    // 0..1 range for a full-scale input.
+    void process(const float* mono, float* bass, float* mid, float* high, int numSamples) noexcept;
+
+    static constexpr double bassUpperHz = 250.0;
+    static constexpr double midUpperHz = 2000.0;
+    static constexpr double envelopeMs = 8.0;
+
+private:
+    static constexpr int numStages = 4;
+    static constexpr int maxLanes = 8;   // widest SIMD register we build for (AVX)
+
+    struct Stage
+    {
+        // Per-lane coefficients, laid out for aligned register loads
+        alignas(32) float a1[maxLanes] {}, a2[maxLanes] {}, a3[maxLanes] {}, k[maxLanes] {};
+        alignas(32) float mixLow[maxLanes] {}, mixHigh[maxLanes] {}, mixDry[maxLanes] {};
+        alignas(32) float ic1[maxLanes] {}, ic2[maxLanes] {};
+    };
+
+    enum class Response { lowPass, highPass, bypass };
+
+    void setStage(int stage, int lane, Response response, double cutoffHz, double sampleRate) noexcept;
+
+    Stage stages[numStages];
+    alignas(32) float envelope[maxLanes] {};
+    float envelopeCoeff = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CrossoverFilterbank)
+};
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    Scope ring overrun/underrun counters and fill-level histograms.
+
+  ==============================================================================
+*/
+
+#include "FifoTelemetry.h"
+
+//==============================================================================
+void FifoTelemetry::prepare(double sampleRate, int ringCapacity) noexcept
+{
+    samplesPerSecond.store(juce::jmax(1, juce::roundToInt(sampleRate)));
+    capacity.store(juce::jmax(1, ringCapacity));
+}
+
+void FifoTelemetry::reset() noexcept
+{
+    pushedSamples.store(0);
+    droppedSamples.store(0);
+    reads.store(0);
+    shortReads.store(0);
+    maxFill.store(0);
+}
+
+//==============================================================================
+void FifoTelemetry::recordPush(int numSamples, juce::uint64 fillLevel) noexcept
+{
+    pushedSamples.fetch_add((juce::uint64)numSamples, std::memory_order_relaxed);
+    samplesThisSecond += numSamples;
+
+    if (! paused.load(std::memory_order_relaxed))
+        recordFill(fillLevel);
+
+    if (samplesThisSecond >= samplesPerSecond.load(std::memory_order_relaxed))
+    {
+        const auto seq = histogramSequence.load(std::memory_order_relaxed);
+        histogramSequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < (size_t)numFillBuckets; ++i)
+            lastSecond[i].store(currentSecond[i], std::memory_order_relaxed);
+
+        histogramSequence.store(seq + 2, std::memory_order_release);
+
+        currentSecond.fill(0);
+        samplesThisSecond = 0;
+    }
+}
+
+void FifoTelemetry::recordFill(juce::uint64 fillLevel) noexcept
+{
+    auto previousMax = maxFill.load(std::memory_order_relaxed);
+    while (fillLevel > previousMax
+           && ! maxFill.compare_exchange_weak(previousMax, fillLevel, std::memory_order_relaxed))
+    {
+    }
+
+    const auto ringCapacity = (juce::uint64)capacity.load(std::memory_order_relaxed);
+    const int bucket = fillLevel >= ringCapacity ? numFillBuckets - 1
+                                                 : (int)((fillLevel * (juce::uint64)numFillBuckets) / ringCapacity);
+    ++currentSecond[(size_t)bucket];
+}
+
+void FifoTelemetry::recordRead(int numSamples, juce::uint64 numSkipped) noexcept
+{
+    reads.fetch_add(1, std::memory_order_relaxed);
+
+    // Resuming: what piled up meanwhile was never going to be read
+    if (! paused.exchange(false, std::memory_order_relaxed))
+        droppedSamples.fetch_add(numSkipped, std::memory_order_relaxed);
+
+    if (numSamples < 2)
+        shortReads.fetch_add(1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+FifoTelemetry::Snapshot FifoTelemetry::getSnapshot() const noexcept
+{
+    Snapshot s;
+    s.pushedSamples = pushedSamples.load(std::memory_order_relaxed);
+    s.droppedSamples = droppedSamples.load(std::memory_order_relaxed);
+    s.reads = reads.load(std::memory_order_relaxed);
+    s.shortReads = shortReads.load(std::memory_order_relaxed);
+    s.maxFill = maxFill.load(std::memory_order_relaxed);
+    s.capacity = capacity.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        const auto before = histogramSequence.load(std::memory_order_acquire);
+
+        if ((before & 1u) == 0)
+        {
+            for (size_t i = 0; i < (size_t)numFillBuckets; ++i)
+                s.fillHistogram[i] = lastSecond[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (histogramSequence.load(std::memory_order_relaxed) == before)
+                return s;
+        }
+
+        juce::Thread::yield();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+// Lock-free health counters for the scope ring.
+//
+// The audio thread records every push with the ring's fill level, the UI
+// thread records every pull. Overruns show up as dropped samples (the
+// producer got more than one read window ahead of the consumer), underruns
+// as short reads (the consumer found fewer than two new samples).
+//
+// Only a consumer that is pulling can fall behind: while paused (none is
+// attached, or it has stopped pulling for a while) fill levels aren't
+// recorded, and the backlog its next read passes over isn't counted as
+// dropped. That read resumes recording.
+class FifoTelemetry
+{
+public:
+    // Fill levels are bucketed in eighths of the ring; the last bucket also
+    // collects pushes made while the ring was completely full.
+    static constexpr int numFillBuckets = 8;
+
+    struct Snapshot
+    {
+        juce::uint64 pushedSamples = 0;
+        juce::uint64 droppedSamples = 0;
+        juce::uint64 reads = 0;
+        juce::uint64 shortReads = 0;
+        juce::uint64 maxFill = 0;
+        int capacity = 0;
+
+        // Pushes per fill bucket during the last complete second
+        std::array<juce::uint32, numFillBuckets> fillHistogram{};
+    };
+
+    void prepare(double sampleRate, int ringCapacity) noexcept;
+    void reset() noexcept;
+
+    // Audio thread
+    void recordPush(int numSamples, juce::uint64 fillLevel) noexcept;
+
+    // Consumer thread
+    void recordRead(int numSamples, juce::uint64 numSkipped) noexcept;
+    void pause() noexcept { paused.store(true, std::memory_order_relaxed); }
+
+    // Any thread
+    Snapshot getSnapshot() const noexcept;
+
+private:
+    void recordFill(juce::uint64 fillLevel) noexcept;
+
+    std::atomic<juce::uint64> pushedSamples{ 0 };
+    std::atomic<juce::uint64> droppedSamples{ 0 };
+    std::atomic<juce::uint64> reads{ 0 };
+    std::atomic<juce::uint64> shortReads{ 0 };
+    std::atomic<juce::uint64> maxFill{ 0 };
+    std::atomic<int> capacity{ 1 };
+    std::atomic<bool> paused{ true };
+
+    // Owned by the audio thread
+    std::array<juce::uint32, numFillBuckets> currentSecond{};
+    int samplesThisSecond = 0;
+    std::atomic<int> samplesPerSecond{ 44100 };
+
+    // Last complete second, behind a seqlock so the histogram reads as a whole
+    std::atomic<juce::uint32> histogramSequence{ 0 };
+    std::array<std::atomic<juce::uint32>, numFillBuckets> lastSecond{};
+};
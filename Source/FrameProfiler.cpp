@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    Per-stage frame timings, kept in a lock-free ring of records.
+
+  ==============================================================================
+*/
+
+#include "FrameProfiler.h"
+
+//==============================================================================
+FrameProfiler::FrameProfiler()
+    : originMs(juce::Time::getMillisecondCounterHiRes())
+{
+}
+
+const char* FrameProfiler::getStageName(int stage) noexcept
+{
+    static const char* const names[] = { "pull", "analysis", "transform", "glow", "core", "fade", "finish", "blit" };
+    static_assert(std::size(names) == numStages, "one name per stage");
+
+    return juce::isPositiveAndBelow(stage, (int)numStages) ? names[stage] : "";
+}
+
+//==============================================================================
+void FrameProfiler::beginFrame() noexcept
+{
+    frameStartMs = juce::Time::getMillisecondCounterHiRes();
+
+    current = {};
+    current.frame = frameCount;
+    current.timeMs = frameStartMs - originMs;
+}
+
+const FrameProfiler::Record& FrameProfiler::endFrame(int width, int height, float renderScale) noexcept
+{
+    current.width = width;
+    current.height = height;
+    current.renderScale = renderScale;
+    current.stageMs[blit] = blitMs.load(std::memory_order_relaxed);
+    current.totalMs = (float)(juce::Time::getMillisecondCounterHiRes() - frameStartMs);
+
+    auto& slot = slots[(size_t)(frameCount % (juce::uint32)capacity)];
+
+    slot.sequence.store(2 * frameCount + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.timeMs.store(current.timeMs, std::memory_order_relaxed);
+    slot.values[0].store((float)current.width, std::memory_order_relaxed);
+    slot.values[1].store((float)current.height, std::memory_order_relaxed);
+    slot.values[2].store(current.renderScale, std::memory_order_relaxed);
+    slot.values[3].store((float)current.samples, std::memory_order_relaxed);
+    slot.values[4].store(current.totalMs, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < (size_t)numStages; ++i)
+        slot.values[5 + i].store(current.stageMs[i], std::memory_order_relaxed);
+
+    slot.sequence.store(2 * (frameCount + 1), std::memory_order_release);
+
+    ++frameCount;
+    published.store(frameCount, std::memory_order_release);
+    return current;
+}
+
+//==============================================================================
+std::vector<FrameProfiler::Record> FrameProfiler::getRecords(int maxRecords) const
+{
+    const auto newest = published.load(std::memory_order_acquire);
+    const auto count = juce::jmin(newest, (juce::uint32)juce::jlimit(0, capacity, maxRecords));
+
+    std::vector<Record> records;
+    records.reserve(count);
+
+    for (auto frame = newest - count; frame != newest; ++frame)
+    {
+        const auto& slot = slots[(size_t)(frame % (juce::uint32)capacity)];
+
+        // Only the frame we asked for, and only if it wasn't rewritten while we read it
+        if (slot.sequence.load(std::memory_order_acquire) != 2 * (frame + 1))
+            continue;
+
+        Record r;
+        r.frame = frame;
+        r.timeMs = slot.timeMs.load(std::memory_order_relaxed);
+        r.width = (int)slot.values[0].load(std::memory_order_relaxed);
+        r.height = (int)slot.values[1].load(std::memory_order_relaxed);
+        r.renderScale = slot.values[2].load(std::memory_order_relaxed);
+        r.samples = (int)slot.values[3].load(std::memory_order_relaxed);
+        r.totalMs = slot.values[4].load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < (size_t)numStages; ++i)
+            r.stageMs[i] = slot.values[5 + i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) == 2 * (frame + 1))
+            records.push_back(r);
+    }
+
+    return records;
+}
+
+void FrameProfiler::writeCsv(const std::vector<Record>& records, juce::OutputStream& out)
+{
+    out << "frame,time_ms,width,height,render_scale,samples";
+
+    for (int stage = 0; stage < numStages; ++stage)
+        out << "," << getStageName(stage) << "_ms";
+
+    out << ",total_ms\n";
+
+    for (const auto& r : records)
+    {
+        out << (int)r.frame << "," << juce::String(r.timeMs, 3) << "," << r.width << "," << r.height << ","
+            << juce::String(r.renderScale, 2) << "," << r.samples;
+
+        for (auto ms : r.stageMs)
+            out << "," << juce::String(ms, 4);
+
+        out << "," << juce::String(r.totalMs, 4) << "\n";
+    }
+}
+
+float FrameProfiler::getPercentile(std::vector<float>& values, float fraction)
+{
+    if (values.empty())
+        return 0.0f;
+
+    const auto index = (size_t)juce::jlimit(0, (int)values.size() - 1, (int)(fraction * (float)values.size()));
+    std::nth_element(values.begin(), values.begin() + (std::ptrdiff_t)index, values.end());
+    return values[index];
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+// Where each frame's time goes.
+//
+// The render thread wraps every stage of a frame in a ScopedStage, and the
+// frame's totals are published into a lock-free ring of records that any
+// thread can copy out: the editor's overlay shows percentiles over the
+// recent ones, and the whole ring can be saved as CSV for comparing
+// backends, settings and builds on real sessions.
+//
+// Presenting happens on the message thread and isn't part of a frame's
+// render call; the last blit time is carried into the next frame's record.
+class FrameProfiler
+{
+public:
+    enum Stage
+    {
+        pull,      // reading the scope rings
+        analysis,  // auto-gain, energy, width and hue passes
+        transform, // mapping samples to points
+        glow,      // stroked glow
+        core,      // core strokes and dots
+        fade,      // persistence decay
+        finish,    // canvas end of frame: bloom and tone-mapping
+        blit,      // presenting on the message thread
+        numStages
+    };
+
+    static const char* getStageName(int stage) noexcept;
+
+    struct Record
+    {
+        juce::uint32 frame = 0;
+        double timeMs = 0.0;          // start of the frame, since the profiler was created
+        int width = 0, height = 0;    // render resolution
+        float renderScale = 1.0f;     // of the window's size
+        int samples = 0;              // drawn, over all traces
+        std::array<float, numStages> stageMs{};
+        float totalMs = 0.0f;         // the whole render call, untimed parts included
+    };
+
+    // Adds the time from construction to destruction to a stage of the current frame
+    class ScopedStage
+    {
+    public:
+        ScopedStage(FrameProfiler& p, Stage s) noexcept
+            : profiler(p), stage(s), startMs(juce::Time::getMillisecondCounterHiRes())
+        {
+        }
+
+        ~ScopedStage() { profiler.addTime(stage, juce::Time::getMillisecondCounterHiRes() - startMs); }
+
+    private:
+        FrameProfiler& profiler;
+        const Stage stage;
+        const double startMs;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+    // Records kept, about 17 seconds at 60 frames per second
+    static constexpr int capacity = 1024;
+
+    FrameProfiler();
+
+    //==============================================================================
+    // Render thread, one frame at a time
+    void beginFrame() noexcept;
+    void addTime(Stage stage, double ms) noexcept { current.stageMs[(size_t)stage] += (float)ms; }
+
+    // Adds the time since lapStartMs to a stage and restarts the lap, for
+    // stages that follow each other in a loop
+    void addLap(Stage stage, double& lapStartMs) noexcept
+    {
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        addTime(stage, now - lapStartMs);
+        lapStartMs = now;
+    }
+
+    void addSamples(int numSamples) noexcept { current.samples += numSamples; }
+    const Record& endFrame(int width, int height, float renderScale) noexcept;
+
+    // Message thread, after presenting a frame
+    void setBlitTime(double ms) noexcept { blitMs.store((float)ms, std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Any thread. Up to maxRecords of the newest records, oldest first.
+    std::vector<Record> getRecords(int maxRecords = capacity) const;
+
+    // One row per record, with a header
+    static void writeCsv(const std::vector<Record>& records, juce::OutputStream& out);
+
+    // The value below which fraction (0..1) of values lie; reorders values
+    static float getPercentile(std::vector<float>& values, float fraction);
+
+private:
+    // A record as stored in the ring: sequence is odd while the render thread
+    // writes the slot, and 2 * (frame + 1) once it is complete
+    struct Slot
+    {
+        std::atomic<juce::uint32> sequence{ 0 };
+        std::atomic<double> timeMs{ 0.0 };
+        std::array<std::atomic<float>, 5 + numStages> values{};
+    };
+
+    const double originMs;
+    double frameStartMs = 0.0;
+    juce::uint32 frameCount = 0;
+    Record current;
+
+    std::atomic<float> blitMs{ 0.0f };
+    std::atomic<juce::uint32> published{ 0 };
+    std::array<Slot, capacity> slots;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameProfiler)
+};
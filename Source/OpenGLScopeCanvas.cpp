@@ -0,0 +1,463 @@
+/*
+  ==============================================================================
+
+    OpenGL backend for the scope renderer.
+
+  ==============================================================================
+*/
+
+#include "OpenGLScopeCanvas.h"
+
+using namespace juce::gl;
+
+namespace
+{
+    // Positions arrive in component pixels and are mapped to clip space here
+    const char* const vertexShader = R"(
+        attribute vec2 position;
+        attribute vec2 shape;
+        attribute vec4 colour;
+
+        uniform vec2 viewSize;
+
+        varying vec2 vShape;
+        varying vec4 vColour;
+
+        void main()
+        {
+            vShape = shape;
+            vColour = colour;
+            gl_Position = vec4(position.x / viewSize.x * 2.0 - 1.0,
+                               1.0 - position.y / viewSize.y * 2.0, 0.0, 1.0);
+        }
+    )";
+
+    // Distance from the stroke centre line (or dot centre) gives an
+    // antialiased edge one pixel wide
+    const char* const fragmentShader = R"(
+        varying vec2 vShape;
+        varying vec4 vColour;
+
+        void main()
+        {
+            float d = length(vShape);
+            float edge = max(fwidth(d), 0.0001);
+            float coverage = 1.0 - smoothstep(1.0 - edge, 1.0, d);
+            gl_FragColor = vec4(vColour.rgb, vColour.a * coverage);
+        }
+    )";
+
+    // Accumulated light to the screen, with the software canvas's tone curve
+    const char* const presentVertexShader = R"(
+        attribute vec2 position;
+
+        varying vec2 vTexCoord;
+
+        void main()
+        {
+            vTexCoord = position * 0.5 + 0.5;
+            gl_Position = vec4(position, 0.0, 1.0);
+        }
+    )";
+
+    const char* const presentFragmentShader = R"(
+        uniform sampler2D light;
+        uniform float exposure;
+
+        varying vec2 vTexCoord;
+
+        void main()
+        {
+            vec3 v = texture2D(light, vTexCoord).rgb * exposure;
+            gl_FragColor = vec4(1.0 - 1.0 / (1.0 + v + 0.5 * v * v), 1.0);
+        }
+    )";
+
+    // Give up on a context that hasn't come up after this long on screen
+    constexpr juce::uint32 startupTimeoutMs = 2000;
+}
+
+//==============================================================================
+OpenGLScopeCanvas::OpenGLScopeCanvas(juce::Component& targetToUse)
+    : target(targetToUse)
+{
+    context.setRenderer(this);
+    context.setOpenGLVersionRequired(juce::OpenGLContext::openGL3_2);
+    context.setComponentPaintingEnabled(true); // overlays still come from paint()
+    context.setContinuousRepainting(false);
+    context.attachTo(target);
+}
+
+OpenGLScopeCanvas::~OpenGLScopeCanvas()
+{
+    context.detach();
+}
+
+bool OpenGLScopeCanvas::hasTimedOut() noexcept
+{
+    // Only time on screen counts: a hidden or minimised window gets no context
+    if (ready.load() || ! target.isShowing())
+    {
+        waitingSince = 0;
+        return false;
+    }
+
+    const auto now = juce::Time::getMillisecondCounter();
+
+    if (waitingSince == 0)
+        waitingSince = now;
+
+    return now - waitingSince > startupTimeoutMs;
+}
+
+//==============================================================================
+void OpenGLScopeCanvas::beginFrame(int width, int height, float fadeAlpha)
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(pendingLock);
+
+        if (! spare.empty())
+        {
+            current = std::move(spare.back());
+            spare.pop_back();
+        }
+    }
+
+    if (current == nullptr)
+        current = std::make_unique<Frame>();
+
+    current->width = width;
+    current->height = height;
+    current->fadeAlpha = fadeAlpha;
+    current->vertices.clear();
+    current->batches.clear();
+
+    setClip(juce::Rectangle<int>(width, height).toFloat());
+}
+
+void OpenGLScopeCanvas::setClip(juce::Rectangle<float> area)
+{
+    auto& batches = current->batches;
+
+    if (! batches.empty() && batches.back().count == 0)
+        batches.pop_back();
+
+    Batch batch;
+    batch.clip = area;
+    batch.start = (int)current->vertices.size();
+    batches.push_back(batch);
+}
+
+void OpenGLScopeCanvas::drawSegment(juce::Point<float> start, juce::Point<float> end, float thickness, juce::Colour colour)
+{
+    const auto direction = end - start;
+    const float length = direction.getDistanceFromOrigin();
+
+    if (length <= 0.0f)
+        return;
+
+    const float halfWidth = 0.5f * juce::jmax(1.0f, thickness);
+    const juce::Point<float> normal(-direction.y / length * halfWidth, direction.x / length * halfWidth);
+
+    const float r = colour.getFloatRed(), g = colour.getFloatGreen(), b = colour.getFloatBlue(), a = colour.getFloatAlpha();
+
+    const Vertex corners[4] = { { start.x + normal.x, start.y + normal.y, 0.0f,  1.0f, r, g, b, a },
+                                { start.x - normal.x, start.y - normal.y, 0.0f, -1.0f, r, g, b, a },
+                                { end.x + normal.x,   end.y + normal.y,   0.0f,  1.0f, r, g, b, a },
+                                { end.x - normal.x,   end.y - normal.y,   0.0f, -1.0f, r, g, b, a } };
+    addQuad(corners);
+}
+
+void OpenGLScopeCanvas::drawDot(juce::Point<float> centre, float diameter, juce::Colour colour)
+{
+    const float radius = 0.5f * juce::jmax(1.0f, diameter);
+    const float r = colour.getFloatRed(), g = colour.getFloatGreen(), b = colour.getFloatBlue(), a = colour.getFloatAlpha();
+
+    const Vertex corners[4] = { { centre.x - radius, centre.y - radius, -1.0f, -1.0f, r, g, b, a },
+                                { centre.x + radius, centre.y - radius,  1.0f, -1.0f, r, g, b, a },
+                                { centre.x - radius, centre.y + radius, -1.0f,  1.0f, r, g, b, a },
+                                { centre.x + radius, centre.y + radius,  1.0f,  1.0f, r, g, b, a } };
+    addQuad(corners);
+}
+
+void OpenGLScopeCanvas::addQuad(const Vertex (&corners)[4])
+{
+    auto& vertices = current->vertices;
+
+    vertices.push_back(corners[0]);
+    vertices.push_back(corners[1]);
+    vertices.push_back(corners[2]);
+    vertices.push_back(corners[2]);
+    vertices.push_back(corners[1]);
+    vertices.push_back(corners[3]);
+
+    current->batches.back().count += 6;
+}
+
+void OpenGLScopeCanvas::endFrame()
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(pendingLock);
+
+        // The GL thread has fallen behind: drop the oldest geometry but keep
+        // its fade, so persistence decays at the same rate
+        if ((int)pending.size() >= maxPendingFrames)
+        {
+            auto oldest = std::move(pending.front());
+            pending.erase(pending.begin());
+
+            auto& next = pending.empty() ? *current : *pending.front();
+            next.fadeAlpha = 1.0f - (1.0f - next.fadeAlpha) * (1.0f - oldest->fadeAlpha);
+            spare.push_back(std::move(oldest));
+        }
+
+        pending.push_back(std::move(current));
+    }
+
+    context.triggerRepaint();
+}
+
+//==============================================================================
+void OpenGLScopeCanvas::newOpenGLContextCreated()
+{
+    const auto build = [this](const char* vertexSource, const char* fragmentSource)
+    {
+        auto shader = std::make_unique<juce::OpenGLShaderProgram>(context);
+
+        if (! shader->addVertexShader(juce::OpenGLHelpers::translateVertexShaderToV3(vertexSource))
+            || ! shader->addFragmentShader(juce::OpenGLHelpers::translateFragmentShaderToV3(fragmentSource))
+            || ! shader->link())
+        {
+            lastError = shader->getLastError().trim();
+            shader.reset();
+        }
+
+        return shader;
+    };
+
+    auto shader = build(vertexShader, fragmentShader);
+    auto presentShader = build(presentVertexShader, presentFragmentShader);
+
+    if (shader == nullptr || presentShader == nullptr)
+    {
+        failed.store(true);
+        return;
+    }
+
+    program = std::move(shader);
+    viewSizeUniform = std::make_unique<juce::OpenGLShaderProgram::Uniform>(*program, "viewSize");
+    positionAttribute = glGetAttribLocation(program->getProgramID(), "position");
+    shapeAttribute = glGetAttribLocation(program->getProgramID(), "shape");
+    colourAttribute = glGetAttribLocation(program->getProgramID(), "colour");
+
+    presentProgram = std::move(presentShader);
+    lightUniform = std::make_unique<juce::OpenGLShaderProgram::Uniform>(*presentProgram, "light");
+    exposureUniform = std::make_unique<juce::OpenGLShaderProgram::Uniform>(*presentProgram, "exposure");
+    presentPositionAttribute = glGetAttribLocation(presentProgram->getProgramID(), "position");
+
+    glGenBuffers(1, &vertexBuffer);
+    ready.store(true);
+}
+
+void OpenGLScopeCanvas::openGLContextClosing()
+{
+    ready.store(false);
+
+    if (vertexBuffer != 0)
+        glDeleteBuffers(1, &vertexBuffer);
+
+    vertexBuffer = 0;
+    releaseAccumulation();
+    lightUniform.reset();
+    exposureUniform.reset();
+    presentProgram.reset();
+    viewSizeUniform.reset();
+    program.reset();
+}
+
+bool OpenGLScopeCanvas::resizeAccumulation(int newWidth, int newHeight)
+{
+    releaseAccumulation();
+
+    // 32-bit float rather than 16: with half floats' 11-bit mantissa a decay
+    // within 1/2048 of one (a long trail at a high refresh rate) rounds back
+    // to the same value and the trail stops fading
+    glGenTextures(1, &accumulationTexture);
+    glBindTexture(GL_TEXTURE_2D, accumulationTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, newWidth, newHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &accumulationFrameBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, accumulationFrameBuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumulationTexture, 0);
+
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    if (complete)
+    {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        accumulationWidth = newWidth;
+        accumulationHeight = newHeight;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, context.getFrameBufferID());
+
+    if (! complete)
+        releaseAccumulation();
+
+    return complete;
+}
+
+void OpenGLScopeCanvas::releaseAccumulation()
+{
+    if (accumulationFrameBuffer != 0)
+        glDeleteFramebuffers(1, &accumulationFrameBuffer);
+
+    if (accumulationTexture != 0)
+        glDeleteTextures(1, &accumulationTexture);
+
+    accumulationFrameBuffer = accumulationTexture = 0;
+    accumulationWidth = accumulationHeight = 0;
+}
+
+void OpenGLScopeCanvas::renderOpenGL()
+{
+    if (program == nullptr)
+        return;
+
+    std::vector<std::unique_ptr<Frame>> frames;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(pendingLock);
+        frames.swap(pending);
+    }
+
+    const double scale = context.getRenderingScale();
+    const int screenWidth = juce::roundToInt(scale * target.getWidth());
+    const int screenHeight = juce::roundToInt(scale * target.getHeight());
+
+    if (screenWidth <= 0 || screenHeight <= 0)
+        return;
+
+    // A float target that can't be rendered to is as good as a shader that
+    // didn't build: the owner goes back to software
+    if ((accumulationFrameBuffer == 0 || accumulationWidth != screenWidth || accumulationHeight != screenHeight)
+        && ! resizeAccumulation(screenWidth, screenHeight))
+    {
+        lastError = "Float framebuffer not supported";
+        failed.store(true);
+        return;
+    }
+
+    if (! frames.empty())
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, accumulationFrameBuffer);
+
+        glViewport(0, 0, screenWidth, screenHeight);
+        glEnable(GL_BLEND);
+
+        program->use();
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+        for (auto& frame : frames)
+        {
+            if (frame->width <= 0 || frame->height <= 0)
+                continue;
+
+            viewSizeUniform->set((float)frame->width, (float)frame->height);
+
+            // Persistence: a quad over the whole frame whose blend multiplies
+            // what's there by the decay; its own colour doesn't count
+            const float w = (float)frame->width, h = (float)frame->height, keep = 1.0f - frame->fadeAlpha;
+            const Vertex fadeQuad[6] = { { 0, 0, 0, 0, 0, 0, 0, 0 }, { w, 0, 0, 0, 0, 0, 0, 0 }, { 0, h, 0, 0, 0, 0, 0, 0 },
+                                         { 0, h, 0, 0, 0, 0, 0, 0 }, { w, 0, 0, 0, 0, 0, 0, 0 }, { w, h, 0, 0, 0, 0, 0, 0 } };
+            glDisable(GL_SCISSOR_TEST);
+            glBlendColor(keep, keep, keep, keep);
+            glBlendFunc(GL_ZERO, GL_CONSTANT_COLOR);
+            drawVertices(fadeQuad, 6);
+
+            // Geometry, one scissor rectangle per tile; light adds up
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            const float sx = (float)screenWidth / w, sy = (float)screenHeight / h;
+            glEnable(GL_SCISSOR_TEST);
+
+            for (auto& batch : frame->batches)
+            {
+                if (batch.count == 0)
+                    continue;
+
+                const auto clip = batch.clip;
+                glScissor(juce::roundToInt(clip.getX() * sx),
+                          juce::roundToInt((h - clip.getBottom()) * sy),
+                          juce::roundToInt(clip.getWidth() * sx),
+                          juce::roundToInt(clip.getHeight() * sy));
+
+                drawVertices(frame->vertices.data() + batch.start, batch.count);
+            }
+
+            glDisable(GL_SCISSOR_TEST);
+        }
+
+        glDisable(GL_BLEND);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, context.getFrameBufferID());
+
+        const juce::SpinLock::ScopedLockType sl(pendingLock);
+
+        for (auto& frame : frames)
+            spare.push_back(std::move(frame));
+    }
+
+    present(screenWidth, screenHeight);
+}
+
+void OpenGLScopeCanvas::present(int screenWidth, int screenHeight)
+{
+    // One quad over the window, tone-mapping the accumulated light into it
+    const GLfloat corners[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+
+    glBindFramebuffer(GL_FRAMEBUFFER, context.getFrameBufferID());
+    glViewport(0, 0, screenWidth, screenHeight);
+    glDisable(GL_BLEND);
+
+    presentProgram->use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, accumulationTexture);
+    lightUniform->set(0);
+    exposureUniform->set(exposure);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(corners), corners, GL_STREAM_DRAW);
+    glVertexAttribPointer((GLuint)presentPositionAttribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glEnableVertexAttribArray((GLuint)presentPositionAttribute);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glDisableVertexAttribArray((GLuint)presentPositionAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void OpenGLScopeCanvas::drawVertices(const Vertex* vertices, int numVertices)
+{
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)((size_t)numVertices * sizeof(Vertex)), vertices, GL_STREAM_DRAW);
+
+    const auto stride = (GLsizei)sizeof(Vertex);
+    glVertexAttribPointer((GLuint)positionAttribute, 2, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(Vertex, x));
+    glVertexAttribPointer((GLuint)shapeAttribute, 2, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(Vertex, shapeX));
+    glVertexAttribPointer((GLuint)colourAttribute, 4, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(Vertex, r));
+    glEnableVertexAttribArray((GLuint)positionAttribute);
+    glEnableVertexAttribArray((GLuint)shapeAttribute);
+    glEnableVertexAttribArray((GLuint)colourAttribute);
+
+    glDrawArrays(GL_TRIANGLES, 0, numVertices);
+
+    glDisableVertexAttribArray((GLuint)positionAttribute);
+    glDisableVertexAttribArray((GLuint)shapeAttribute);
+    glDisableVertexAttribArray((GLuint)colourAttribute);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScopeCanvas.h"
+
+//==============================================================================
+// The GPU backend. Attaches an OpenGLContext to the target component; the
+// render worker turns strokes and dots into a triangle vertex stream, and the
+// GL thread replays each frame's decay and geometry into a float
+// accumulation target with one small shader, then tone-maps it to the screen.
+//
+// Like the software canvas's planes, the target holds linear light: decay
+// is a multiply (so trails reach black instead of sticking at the last 8-bit
+// step), strokes add up, and presenting applies the same tone curve.
+//
+// Sticks to GL 3.2 and plain GLSL, so software implementations such as Mesa
+// llvmpipe run it too. If the shaders don't build, hasFailed() turns true and
+// the owner should go back to software. A context that doesn't come up while
+// the target is on screen makes hasTimedOut() true instead: the owner should
+// fall back for now, but may try again later (say, when it's shown again).
+class OpenGLScopeCanvas : public ScopeCanvas,
+                          private juce::OpenGLRenderer
+{
+public:
+    explicit OpenGLScopeCanvas(juce::Component& target);
+    ~OpenGLScopeCanvas() override;
+
+    // Message thread
+    bool isReady() const noexcept { return ready.load(); }
+    bool hasFailed() const noexcept { return failed.load(); }
+    const juce::String& getLastError() const noexcept { return lastError; } // once hasFailed()
+    bool hasTimedOut() noexcept;
+    void triggerRepaint() { context.triggerRepaint(); }
+
+    // ScopeCanvas (render thread)
+    void beginFrame(int width, int height, float fadeAlpha) override;
+    void setClip(juce::Rectangle<float> area) override;
+    void drawSegment(juce::Point<float> start, juce::Point<float> end, float thickness, juce::Colour colour) override;
+    void drawDot(juce::Point<float> centre, float diameter, juce::Colour colour) override;
+    void endFrame() override;
+
+private:
+    struct Vertex
+    {
+        float x, y;          // component pixels
+        float shapeX, shapeY; // -1..1 across the stroke or dot; the shader fades the edge
+        float r, g, b, a;
+    };
+
+    // A run of vertices sharing one clip rectangle
+    struct Batch
+    {
+        juce::Rectangle<float> clip;
+        int start = 0, count = 0;
+    };
+
+    struct Frame
+    {
+        int width = 0, height = 0;
+        float fadeAlpha = 0.0f;
+        std::vector<Vertex> vertices;
+        std::vector<Batch> batches;
+    };
+
+    // OpenGLRenderer (GL thread)
+    void newOpenGLContextCreated() override;
+    void renderOpenGL() override;
+    void openGLContextClosing() override;
+
+    // Two triangles: corners 0-1-2 and 2-1-3
+    void addQuad(const Vertex (&corners)[4]);
+    void drawVertices(const Vertex* vertices, int numVertices);
+
+    bool resizeAccumulation(int newWidth, int newHeight);
+    void releaseAccumulation();
+    void present(int screenWidth, int screenHeight);
+
+    static constexpr int maxPendingFrames = 4;
+
+    juce::Component& target;
+    juce::OpenGLContext context;
+
+    // Render thread -> GL thread
+    juce::SpinLock pendingLock;
+    std::vector<std::unique_ptr<Frame>> pending, spare;
+    std::unique_ptr<Frame> current;
+
+    // GL thread only
+    std::unique_ptr<juce::OpenGLShaderProgram> program;
+    std::unique_ptr<juce::OpenGLShaderProgram::Uniform> viewSizeUniform;
+    std::unique_ptr<juce::OpenGLShaderProgram> presentProgram;
+    std::unique_ptr<juce::OpenGLShaderProgram::Uniform> lightUniform, exposureUniform;
+    GLuint accumulationTexture = 0, accumulationFrameBuffer = 0; // RGBA32F
+    int accumulationWidth = 0, accumulationHeight = 0;
+    GLuint vertexBuffer = 0;
+    int positionAttribute = -1, shapeAttribute = -1, colourAttribute = -1, presentPositionAttribute = -1;
+
+    std::atomic<bool> ready{ false };
+    std::atomic<bool> failed{ false };
+    juce::String lastError; // GL thread, until failed is set
+    juce::uint32 waitingSince = 0; // message thread; 0 while not waiting on screen
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OpenGLScopeCanvas)
+};
@@ -10,482 +10,449 @@
 #include "PluginEditor.h"
 
 //==============================================================================
-void XYscopeAudioProcessorEditor::timerCallback()
+bool XYscopeAudioProcessorEditor::prepareScheduledFrame(int& pixelArea)
+{
+    // Only feed the scope while the window can actually be seen
+    const bool showing = isShowing();
+
+    if (showing != scopeAttached)
+    {
+        scopeAttached = showing;
+
+        // A context that timed out gets another chance each time we're shown
+        if (showing)
+        {
+            openGLTimedOut = false;
+            processor.attachScopeViewer();
+        }
+        else
+            processor.detachScopeViewer();
+
+        overlaysChanged = true;
+    }
+
+    // Instances that have been deleted stop being overlaid
+    for (auto& stream : renderer.getOverlaySources())
+    {
+        if (stream->isOrphaned())
+        {
+            overlayIds.removeFirstMatchingValue(stream->getId());
+            overlaysChanged = true;
+        }
+    }
+
+    if (overlaysChanged)
+    {
+        overlaysChanged = false;
+        renderer.setOverlaySources(showing ? findOverlayStreams() : juce::Array<ScopeStream::Ptr>());
+        wakeRequested.store(true);
+    }
+
+    updateCanvas();
+
+    if (! showing || getWidth() <= 0 || getHeight() <= 0)
+        return false;
+
+    // Idle: everything has faded and no signal is coming in, so another frame
+    // would look exactly like the last one
+    const bool resized = getWidth() != renderWidth.load() || getHeight() != renderHeight.load();
+
+    if (renderer.isIdle() && ! resized && ! wakeRequested.exchange(false) && ! renderer.hasNewSignal())
+        return false;
+
+    wakeRequested.store(false);
+    renderer.setFrameBudgetMs(processor.getFrameBudgetMs());
+    renderer.setPointBudget(processor.getPointBudget());
+
+    renderWidth.store(getWidth());
+    renderHeight.store(getHeight());
+    pixelArea = getWidth() * getHeight();
+    return true;
+}
+
+void XYscopeAudioProcessorEditor::renderScheduledFrame()
+{
+    renderer.renderFrame(renderWidth.load(), renderHeight.load());
+}
+
+void XYscopeAudioProcessorEditor::presentScheduledFrame()
 {
-    renderFrame();
     repaint();
 }
-//===============================================================================
-void XYscopeAudioProcessorEditor::renderFrame()
+
+void XYscopeAudioProcessorEditor::updateCanvas()
 {
-    const int N = 4096;
-    if ((int)scratchL.size() != N)
+    const bool wantsOpenGL = processor.isOpenGLEnabled() && ! openGLUnavailable && ! openGLTimedOut;
+
+    if (wantsOpenGL && glCanvas == nullptr)
+        glCanvas = std::make_unique<OpenGLScopeCanvas>(*this);
+
+    // No shaders on this machine: back to software for good. No context yet:
+    // back to software until the window is shown again.
+    if (glCanvas != nullptr && glCanvas->hasFailed())
     {
-        scratchL.resize(N);
-        scratchR.resize(N);
-        points.resize(N);
+        openGLUnavailable = true;
+        openGLError = glCanvas->getLastError();
     }
 
-    const int got = processor.pullSamples(scratchL.data(), scratchR.data(), N);
-    if (got < 2)
-        return;
+    if (glCanvas != nullptr && glCanvas->hasTimedOut())
+        openGLTimedOut = true;
 
-    // --- Visual auto-gain (AGC) ---
-    float peak = 1.0e-6f; // avoid divide-by-zero
-    for (int i = 0; i < got; ++i)
+    if (glCanvas != nullptr && (! wantsOpenGL || openGLUnavailable || openGLTimedOut))
     {
-        // Use mid or max of L/R; choose what "fills" best for your aesthetic
-        float m = 0.5f * (std::fabs(scratchL[i]) + std::fabs(scratchR[i]));
-        if (m > peak) peak = m;
+        renderer.setCanvas(nullptr);
+        glCanvas.reset();
+        repaint();
     }
 
-    // --- Global energy for colour (frame-level) ---
-    float e = 0.0f;
-    for (int i = 0; i < got; ++i)
+    const bool wasSoftware = renderer.isUsingSoftwareCanvas();
+    renderer.setCanvas(isDrawingWithOpenGL() ? glCanvas.get() : nullptr);
+
+    // A fresh canvas starts out black, even if the scope is idle
+    if (renderer.isUsingSoftwareCanvas() != wasSoftware)
+        wakeRequested.store(true);
+}
+//==============================================================================
+XYscopeAudioProcessorEditor::XYscopeAudioProcessorEditor(XYscopeAudioProcessor& p)
+    : AudioProcessorEditor(&p),
+    processor(p),
+    renderer(p),
+    vblank(this, [this] { scheduler->handleVBlank(); })
+{
+    setSize(600, 600);
+
+    setResizable(true, true);
+    setResizeLimits(300, 300, 2400, 2400); // pick sensible max for your display
+    setWantsKeyboardFocus(true);
+
+    // Frames come from the process-wide scheduler rather than a timer per editor
+    scheduler->addClient(this);
+    processor.addListener(this);
+
+}
+
+
+
+XYscopeAudioProcessorEditor::~XYscopeAudioProcessorEditor()
+{
+    processor.removeListener(this);
+    scheduler->removeClient(this);
+
+    renderer.setCanvas(nullptr);
+    glCanvas.reset();
+
+    if (scopeAttached)
+        processor.detachScopeViewer();
+}
+
+//==============================================================================
+void XYscopeAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    // Rendering happens on the scheduler's workers; paint is only a blit of
+    // the newest finished frame. With OpenGL the scope is already on screen
+    // and paint only adds the overlays.
+    if (! isDrawingWithOpenGL())
     {
-        float m = 0.5f * (scratchL[i] + scratchR[i]); // mid
-        e += m * m;
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+        renderer.drawTo(g, getLocalBounds());
+        renderer.getProfiler().setBlitTime(juce::Time::getMillisecondCounterHiRes() - startMs);
     }
-    e = std::sqrt(e / (float)got); // RMS ~ 0..1
-
-    // Smooth it so colours don't flicker
-    const float colourAttack = 0.25f;
-    const float colourRelease = 0.05f;
-    if (e > colourEnergySmoothed)
-        colourEnergySmoothed += (e - colourEnergySmoothed) * colourAttack;
-    else
-        colourEnergySmoothed += (e - colourEnergySmoothed) * colourRelease;
-
-    // Map RMS to a usable 0..1 control signal (tune these)
-    float energyNorm = juce::jmap(colourEnergySmoothed, 0.02f, 0.25f, 0.0f, 1.0f);
-    energyNorm = juce::jlimit(0.0f, 1.0f, energyNorm);
-
-
-    // We want peak * visualGain ? desiredPeak
-    // desiredPeak is in "audio units" before scale; tune by feel.
-    const float desiredPeak = 0.35f; // 0..1-ish
-    float targetVisualGain = desiredPeak / peak;
-
-    // Clamp so silence doesn't blow up and loud signals don't vanish
-    targetVisualGain = juce::jlimit(0.25f, 20.0f, targetVisualGain);
-
-    // Smooth: faster attack, slower release
-    const float attack = 0.25f;   // increase = faster response to quiet signals
-    const float release = 0.05f;  // decrease = slower drop when signal gets loud
-
-    if (targetVisualGain > visualGainSmoothed)
-        visualGainSmoothed += (targetVisualGain - visualGainSmoothed) * attack;
-    else
-        visualGainSmoothed += (targetVisualGain - visualGainSmoothed) * release;
-
-    const float zoom = processor.zoomParam ? processor.zoomParam->load() : 1.0f;
-    const float gainDb = processor.gainDbParam ? processor.gainDbParam->load() : 0.0f;
-    const float gain = juce::Decibels::decibelsToGain(gainDb);
-    const float deg = processor.rotateDegParam ? processor.rotateDegParam->load() : 0.0f;
-    const float a = juce::degreesToRadians(deg);
-    const float c = std::cos(a);
-    const float s = std::sin(a);
-
-    const float persist = processor.persistParam ? processor.persistParam->load() : 0.85f;
-    const float fadeAlpha = juce::jlimit(0.0f, 1.0f, 1.0f - persist);
-
-    if (!accumulation.isValid()
-        || accumulation.getWidth() != getWidth()
-        || accumulation.getHeight() != getHeight())
+
+    if (processor.getPairView() == XYscopeAudioProcessor::tiledPairs)
+        drawTileLabels(g);
+
+    if (showFifoOverlay)
+        drawFifoOverlay(g);
+
+    if (showProfiler)
+        drawProfilerOverlay(g);
+}
+
+bool XYscopeAudioProcessorEditor::keyPressed(const juce::KeyPress& key)
+{
+    if (key.getTextCharacter() == 'd' || key.getTextCharacter() == 'D')
     {
-        accumulation = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true);
+        showFifoOverlay = ! showFifoOverlay;
+        processor.resetFifoStats();
+        repaint();
+        return true;
     }
 
-    juce::Graphics g(accumulation);
-    g.setColour(juce::Colours::black.withAlpha(fadeAlpha));
-    g.fillAll();
+    if (key.getTextCharacter() == 'p' || key.getTextCharacter() == 'P')
+    {
+        showProfiler = ! showProfiler;
+        repaint();
+        return true;
+    }
 
-    auto area = getLocalBounds().toFloat();
-    const float cx = area.getCentreX();
-    const float cy = area.getCentreY();
-    const float scale = 0.45f * std::min(area.getWidth(), area.getHeight());
+    return false;
+}
 
-    // Draw in chunks with varying thickness and spread
-    const int chunkSize = 128;
-    g.setColour(juce::Colours::white);
+void XYscopeAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
+{
+    if (e.mods.isPopupMenu())
+        showOverlayMenu();
+}
+
+//==============================================================================
+void XYscopeAudioProcessorEditor::showOverlayMenu()
+{
+    const auto ownStream = processor.getScopeStream();
 
-    for (int chunkStart = 0; chunkStart < got; chunkStart += chunkSize)
+    juce::PopupMenu menu;
+
+    // Channel pairs of a multichannel layout; these are ordinary parameters
+    if (processor.getNumChannelPairs() > 1)
     {
-        int chunkEnd = std::min(chunkStart + chunkSize, got);
-        int chunkLen = chunkEnd - chunkStart;
+        menu.addSectionHeader("Channel pairs");
 
-        if (chunkLen < 2)
-            continue;
+        for (int pair = 0; pair < processor.getNumChannelPairs(); ++pair)
+        {
+            auto* param = processor.apvts.getParameter("pair" + juce::String(pair + 1));
+            const bool enabled = param->getValue() > 0.5f;
 
-        // Get user controls
-        const float satControl = processor.saturationParam ? processor.saturationParam->load() : 1.0f;
-        const float hueControl = processor.hueShiftParam ? processor.hueShiftParam->load() : 0.0f;
-        const float monoAmount = processor.monoAmountParam ? processor.monoAmountParam->load() : 0.0f;
-        const float thicknessControl = processor.thicknessParam ? processor.thicknessParam->load() : 1.0f;
-        const int monoShape = processor.monoShapeParam ? (int)processor.monoShapeParam->load() : 0;
-        const int waveType = processor.waveTypeParam ? (int)processor.waveTypeParam->load() : 0;
-        const float glowIntensity = processor.glowIntensityParam ? processor.glowIntensityParam->load() : 1.0f;  
-        const float glowSize = processor.glowSizeParam ? processor.glowSizeParam->load() : 5.0f;
-        const bool particleMode = processor.particleModeParam ? (processor.particleModeParam->load() > 0.5f) : false;
-        const bool fftMode = processor.fftModeParam ? (processor.fftModeParam->load() > 0.5f) : false;
-        const float dcOffset = processor.dcOffsetParam ? processor.dcOffsetParam->load() : 0.0f;          
-        const bool invertColors = processor.invertColorsParam ? (processor.invertColorsParam->load() > 0.5f) : false;     
-
-        // Wave shaping function for radius modulation
-        auto getWaveModulation = [waveType](float phase) -> float
-            {
-                // phase is 0..1 representing one cycle
-                switch (waveType)
+            menu.addItem(processor.getChannelPairName(pair), true, enabled, [param, enabled]
                 {
-                case 0: // Sine (smooth)
-                    return std::sin(phase * juce::MathConstants<float>::twoPi);
-
-                case 1: // Triangle (linear ramps)
-                    return (phase < 0.5f)
-                        ? juce::jmap(phase, 0.0f, 0.5f, -1.0f, 1.0f)
-                        : juce::jmap(phase, 0.5f, 1.0f, 1.0f, -1.0f);
-
-                case 2: // Square (hard edges)
-                    return (phase < 0.5f) ? 1.0f : -1.0f;
-
-                case 3: // Sawtooth (ramp up, snap down)
-                    return juce::jmap(phase, 0.0f, 1.0f, -1.0f, 1.0f);
-
-                default:
-                    return std::sin(phase * juce::MathConstants<float>::twoPi);
-                }
-            };
-        // Calculate stereo width for this chunk
-        float widthSum = 0.0f;
-        for (int i = chunkStart; i < chunkEnd; ++i)
-        {
-            float diff = std::abs(scratchL[i] - scratchR[i]);
-            widthSum += diff;
+                    param->setValueNotifyingHost(enabled ? 0.0f : 1.0f);
+                });
         }
 
-        float stereoWidth = widthSum / (float)chunkLen;
-        stereoWidth = juce::jlimit(0.0f, 1.0f, stereoWidth * 0.5f);
-        stereoWidth *= (1.0f - monoAmount);
+        auto* viewParam = processor.apvts.getParameter("pairView");
+        const bool tiled = processor.getPairView() == XYscopeAudioProcessor::tiledPairs;
 
-        // Chunk energy (RMS-ish)
-        float e = 0.0f;
-        for (int i = chunkStart; i < chunkEnd; ++i)
-        {
-            float m = 0.5f * (scratchL[i] + scratchR[i]);
-            e += m * m;
-        }
-        e = std::sqrt(e / (float)chunkLen); // RMS 0..~1
-
-        // Map energy to hue: clamp to a reasonable range
-        float energyNorm = juce::jlimit(0.0f, 1.0f, e * 3.0f); // tune multiplier
-        float hue = juce::jmap(energyNorm, 0.0f, 1.0f, 0.60f, 0.00f); // blue->red
-        float sat = juce::jmap(stereoWidth, 0.0f, 1.0f, 0.25f, 1.0f); // mono less saturated, stereo more
-        float val = 1.0f;
+        menu.addItem("Tile pairs", true, tiled, [viewParam, tiled]
+            {
+                viewParam->setValueNotifyingHost(tiled ? 0.0f : 1.0f);
+            });
 
-        // Hue calculation - either energy-based or frequency-based
-        if (fftMode)
-        {
-            // FFT MODE: Color based on frequency content
-            float bass = processor.bassEnergy.load();
-            float mid = processor.midEnergy.load();
-            float high = processor.highEnergy.load();
-
-            // Map frequencies to hue ranges
-            // Bass = red/orange (0.0-0.1), Mids = green/yellow (0.3-0.4), Highs = blue/cyan (0.5-0.65)
-            float dominantFreq = std::max({ bass, mid, high });
-
-            if (bass == dominantFreq)
-                hue = juce::jmap(bass, 0.0f, 1.0f, 0.0f, 0.1f); // Red-orange for bass
-            else if (mid == dominantFreq)
-                hue = juce::jmap(mid, 0.0f, 1.0f, 0.25f, 0.4f); // Green-yellow for mids
-            else
-                hue = juce::jmap(high, 0.0f, 1.0f, 0.5f, 0.65f); // Cyan-blue for highs
-
-            hue = std::fmod(hue + hueControl + 1.0f, 1.0f);
-
-            if (invertColors)
-               hue = std::fmod(1.0f - hue + 1.0f, 1.0f);
-                
-        }
-        else
-        {
-            // ENERGY MODE: Color based on overall energy (original behavior)
-            hue = juce::jmap(energyNorm, 0.0f, 1.0f, 0.75f, 0.05f);
-            hue = std::fmod(hue + hueControl + 1.0f, 1.0f);
+        menu.addSeparator();
+    }
 
-            if (invertColors)
-                hue = std::fmod(1.0f - hue + 1.0f, 1.0f);
-               
-        }
+    const bool openGL = processor.isOpenGLEnabled();
 
-        // Saturation: controlled by user, modulated by stereo width
-        float baseSat = juce::jmap(stereoWidth, 0.0f, 1.0f, 0.55f, 1.00f);
-        sat = baseSat * satControl;
-        sat = juce::jlimit(0.0f, 1.0f, sat);
+    menu.addItem(openGLUnavailable ? "GPU rendering (unavailable)" : "GPU rendering (OpenGL)",
+                 ! openGLUnavailable, openGL && ! openGLUnavailable, [this, openGL]
+        {
+            openGLTimedOut = false;
+            processor.setOpenGLEnabled(! openGL);
+        });
 
-        // Value (brightness): loud = brighter
-        val = juce::jmap(energyNorm, 0.0f, 1.0f, 0.75f, 1.00f);
+    // First line of the driver's message, e.g. the shader compile error
+    if (openGLUnavailable && openGLError.isNotEmpty())
+        menu.addItem("    " + openGLError.upToFirstOccurrenceOf("\n", false, false), false, false, nullptr);
 
-        // Apply colour
-        g.setColour(juce::Colour::fromHSV(hue, sat, val, 1.0f));
+    // Quality governor: lower resolution and detail when frames take longer than this
+    juce::PopupMenu budgetMenu;
+    const double budget = processor.getFrameBudgetMs();
 
+    budgetMenu.addItem("Off (full quality)", true, budget <= 0.0, [this] { processor.setFrameBudgetMs(0.0); });
 
-        // Map to thickness: mono=thick, stereo=thin
-        float thickness = juce::jmap(stereoWidth, 0.0f, 1.0f, 3.5f, 1.0f);
-        thickness *= thicknessControl;  // Apply user control
+    for (const double option : { 4.0, 6.0, 10.0, 16.0 })
+        budgetMenu.addItem(juce::String(option, 0) + " ms", true, budget == option, [this, option]
+            {
+                processor.setFrameBudgetMs(option);
+            });
 
-        // Calculate spread multiplier: mono gets high multiplier, stereo gets 1.0
-        float spreadMult = juce::jmap(stereoWidth, 0.0f, 1.0f, 20.0f, 1.0f);
+    menu.addSubMenu("Frame time budget", budgetMenu);
 
-        // Calculate waveform contribution: high for mono, zero for stereo
-        float waveformAmount = juce::jmap(stereoWidth, 0.0f, 0.2f, 0.8f, 0.0f);
-        waveformAmount = juce::jlimit(0.0f, 1.0f, waveformAmount);
+    // Point budget: each frame's samples resampled to this many points
+    juce::PopupMenu pointsMenu;
+    const int points = processor.getPointBudget();
 
-        
-        // Transform points for this chunk with dynamic spread
-        for (int i = chunkStart; i < chunkEnd; ++i)
-        {
-            // Calculate mid and side with oscillating DC offset for wavy effect
-            float offsetAmount = std::sin(dcPhase) * dcOffset;  // Oscillating offset
-            float offsetL = scratchL[i] + offsetAmount;
-            float offsetR = scratchR[i] - offsetAmount;
-            float mid = (offsetL + offsetR) * 0.5f;
-            float side = (offsetL - offsetR) * 0.5f;
+    pointsMenu.addItem("Off (every sample)", true, points <= 0, [this] { processor.setPointBudget(0); });
 
-            // Increment phase slowly for wave effect
-            dcPhase += 0.001f * std::abs(dcOffset);  // Speed based on offset amount
+    for (const int option : { 512, 1024, 2048, 4096 })
+        pointsMenu.addItem(juce::String(option) + " points", true, points == option, [this, option]
+            {
+                processor.setPointBudget(option);
+            });
 
-            // Apply mono amount - reduce side signal
-            side *= (1.0f - monoAmount);
+    menu.addSubMenu("Points per frame", pointsMenu);
+    menu.addItem("Save frame timings as CSV...", [this] { saveFrameProfile(); });
 
-            // Apply spread multiplier to side signal
-            side *= spreadMult;
+    menu.addSeparator();
 
-            // For mono content, create circular pattern
-            // For mono content, create pattern based on selected shape
-            const float monoWraps = processor.monoWrapsParam ? processor.monoWrapsParam->load() : 3.0f;
-            float angle = ((float)i / (float)got) * juce::MathConstants<float>::twoPi * monoWraps;
-            float radius = mid * 0.4f * gain * zoom * visualGainSmoothed;
+    const int firstInstanceItem = menu.getNumItems();
+    menu.addSectionHeader("Overlay instances");
 
-            float patternX = 0.0f;
-            float patternY = 0.0f;
+    for (auto& stream : registry->getStreams())
+    {
+        if (stream == ownStream)
+            continue;
 
-            switch (monoShape)
-            {
-            case 0: // Circle
-            {
-                float r = radius; // No modulation for clean circle
-                if (waveType > 0)
-                {
-                    float phase = std::fmod(angle / juce::MathConstants<float>::twoPi, 1.0f);
-                    float modulation = getWaveModulation(phase);
-                    r = radius * (1.0f + 0.3f * modulation);
-                }
-                patternX = std::cos(angle) * r;
-                patternY = std::sin(angle) * r;
-                break;
-            }
+        const int id = stream->getId();
 
-            case 1: // Star (5 points)
+        menu.addItem(stream->getName(), true, overlayIds.contains(id), [this, id]
             {
-                float starAngle = angle;
-                float phase = std::fmod(starAngle / juce::MathConstants<float>::twoPi, 0.2f) / 0.2f; // 5 cycles per rotation
-                float modulation = getWaveModulation(phase);
-                float r = radius * (1.0f + 2.0f * modulation);
-                patternX = std::cos(starAngle) * r;
-                patternY = std::sin(starAngle) * r;
-                break;
-            }
+                if (overlayIds.contains(id))
+                    overlayIds.removeFirstMatchingValue(id);
+                else
+                    overlayIds.add(id);
 
-            case 2: // Square
-            {
-                float t = std::fmod(angle / (juce::MathConstants<float>::twoPi), 1.0f);
-                float baseRadius = radius;
+                overlaysChanged = true;
+            });
+    }
 
-                // Add wave modulation
-                if (waveType > 0)
-                {
-                    float phase = std::fmod(angle / juce::MathConstants<float>::twoPi, 1.0f);
-                    float modulation = getWaveModulation(phase);
-                    baseRadius = radius * (1.0f + 0.4f * modulation);
-                }
+    if (menu.getNumItems() <= firstInstanceItem + 1)
+        menu.addItem("No other instances open", false, false, nullptr);
 
-                if (t < 0.25f)
-                {
-                    patternX = baseRadius;
-                    patternY = juce::jmap(t, 0.0f, 0.25f, -baseRadius, baseRadius);
-                }
-                else if (t < 0.5f)
-                {
-                    patternX = juce::jmap(t, 0.25f, 0.5f, baseRadius, -baseRadius);
-                    patternY = baseRadius;
-                }
-                else if (t < 0.75f)
-                {
-                    patternX = -baseRadius;
-                    patternY = juce::jmap(t, 0.5f, 0.75f, baseRadius, -baseRadius);
-                }
-                else
-                {
-                    patternX = juce::jmap(t, 0.75f, 1.0f, -baseRadius, baseRadius);
-                    patternY = -baseRadius;
-                }
-                break;
-            }
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
 
-            case 3: // Spiral
-            {
-                float spiralRadius = radius * (1.0f + angle / (juce::MathConstants<float>::twoPi * monoWraps) * 0.5f);
+juce::Array<ScopeStream::Ptr> XYscopeAudioProcessorEditor::findOverlayStreams() const
+{
+    juce::Array<ScopeStream::Ptr> streams;
 
-                // Add wave modulation to spiral
-                if (waveType > 0)
-                {
-                    float phase = std::fmod(angle / juce::MathConstants<float>::twoPi, 1.0f);
-                    float modulation = getWaveModulation(phase);
-                    spiralRadius *= (1.0f + 0.3f * modulation);
-                }
-
-                patternX = std::cos(angle) * spiralRadius;
-                patternY = std::sin(angle) * spiralRadius;
-                break;
-            }
+    for (auto id : overlayIds)
+        if (auto stream = registry->findStream(id))
+            streams.add(stream);
 
-            default: // Fallback to circle
-                patternX = std::cos(angle) * radius;
-                patternY = std::sin(angle) * radius;
-                break;
-            }
+    return streams;
+}
 
-            // Stereo XY component
-            float stereoX = (mid + side) * gain * zoom * visualGainSmoothed;
-            float stereoY = (mid - side) * gain * zoom * visualGainSmoothed;
+void XYscopeAudioProcessorEditor::drawTileLabels(juce::Graphics& g)
+{
+    const auto shown = renderer.getShownPairs();
+    const int numTiles = juce::countNumberOfBits(shown);
 
-            // Blend between stereo XY and mono pattern
-            float x = stereoX * (1.0f - waveformAmount) + patternX * waveformAmount;
-            float y = stereoY * (1.0f - waveformAmount) + patternY * waveformAmount;
+    if (numTiles <= 1)
+        return;
 
-            // Apply rotation
-            float xr = x * c - y * s;
-            float yr = x * s + y * c;
-            points[i] = { cx + xr * scale, cy - yr * scale };
-        }
+    g.setFont(juce::FontOptions(12.0f));
 
-        if (particleMode)
-        {
-            // PARTICLE RENDERING MODE
-            for (int i = chunkStart; i < chunkEnd; i += 4)
-            {
-                float progress = (float)(i - chunkStart) / (float)chunkLen;
-                float segmentHue = std::fmod(hue + progress * 0.3f, 1.0f);
+    for (int pair = 0, tile = 0; pair < XYscopeAudioProcessor::maxChannelPairs; ++pair)
+    {
+        if ((shown & (1u << pair)) == 0)
+            continue;
 
-                // Particle size based on amplitude
-                float particleSize = thickness * 2.0f;
+        const auto area = ScopeRenderer::getTileBounds(getLocalBounds().toFloat(), numTiles, tile++);
 
-                // Draw glow for particle
-                if (glowIntensity > 0.0f)
-                {
-                    for (int glowPass = 0; glowPass < 3; ++glowPass)
-                    {
-                        float glowMult = glowSize - (glowPass * glowSize * 0.3f);
-                        float glowAlpha = (0.15f / (glowPass + 1)) * glowIntensity;
-
-                        // Glow stays saturated (progressively less saturated each layer for smooth gradient)
-                        float glowSat = juce::jmap((float)glowPass, 0.0f, 2.0f, 1.0f, 0.7f); // Outer layers slightly less saturated
-                        g.setColour(juce::Colour::fromHSV(segmentHue, glowSat, val, glowAlpha));
-                        g.fillEllipse(points[i].x - (particleSize * glowMult) / 2,
-                            points[i].y - (particleSize * glowMult) / 2,
-                            particleSize * glowMult,
-                            particleSize * glowMult);
-                    }
-                }
-
-                // Draw core particle
-                g.setColour(juce::Colour::fromHSV(segmentHue, sat, val, 1.0f));
-                g.fillEllipse(points[i].x - particleSize / 2,
-                    points[i].y - particleSize / 2,
-                    particleSize,
-                    particleSize);
-            }
-        }
-        else
-        {
-            // LINE RENDERING MODE
-// Multi-layer glow
-            for (int glowPass = 0; glowPass < 3; ++glowPass)
-            {
-                float glowMult = glowSize - (glowPass * glowSize * 0.3f);
-                float glowAlpha = (0.15f / (glowPass + 1)) * glowIntensity;
+        g.setColour(juce::Colours::white.withAlpha(0.15f));
+        g.drawRect(area, 1.0f);
 
-                for (int i = chunkStart; i < chunkEnd - 1; ++i)
-                {
-                    float progress = (float)(i - chunkStart) / (float)chunkLen;
-                    float segmentHue = std::fmod(hue + progress * 0.3f, 1.0f);
+        g.setColour(juce::Colours::white.withAlpha(0.6f));
+        g.drawText(processor.getChannelPairName(pair), area.reduced(6.0f).toNearestInt(), juce::Justification::topLeft);
+    }
+}
 
-                    // Glow stays saturated (progressively less saturated each layer)
-                    float glowSat = juce::jmap((float)glowPass, 0.0f, 2.0f, 1.0f, 0.7f);
-                    g.setColour(juce::Colour::fromHSV(segmentHue, glowSat, val, glowAlpha));
+void XYscopeAudioProcessorEditor::drawFifoOverlay(juce::Graphics& g)
+{
+    const auto stats = processor.getFifoStats();
 
-                    juce::Line<float> line(points[i], points[i + 1]);
-                    g.drawLine(line, thickness * glowMult);  // This is the key - thick glow lines
-                }
-            }
+    auto area = getLocalBounds().reduced(8).removeFromTop(130).removeFromLeft(240);
+    g.setColour(juce::Colours::black.withAlpha(0.7f));
+    g.fillRect(area);
 
-            // Core pass: solid line on top (desaturates with saturation control)
-            for (int i = chunkStart; i < chunkEnd - 1; ++i)
-            {
-                float progress = (float)(i - chunkStart) / (float)chunkLen;
-                float segmentHue = std::fmod(hue + progress * 0.3f, 1.0f);
+    area = area.reduced(6);
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::FontOptions(12.0f));
 
-                // Core uses user saturation control (can go to white)
-                g.setColour(juce::Colour::fromHSV(segmentHue, sat, val, 1.0f));
+    auto line = [&](const juce::String& text)
+        {
+            g.drawText(text, area.removeFromTop(15), juce::Justification::centredLeft);
+        };
 
-                juce::Line<float> line(points[i], points[i + 1]);
-                g.drawLine(line, thickness);
-            }
+    line("pushed " + juce::String(stats.pushedSamples) + "   dropped " + juce::String(stats.droppedSamples));
+    line("reads " + juce::String(stats.reads) + "   short " + juce::String(stats.shortReads));
+    line("max fill " + juce::String(stats.maxFill) + " / " + juce::String(stats.capacity));
+    line("fill histogram (last second, 0 -> full)");
 
-            // Core pass: solid line on top
-            for (int i = chunkStart; i < chunkEnd - 1; ++i)
-            {
-                float progress = (float)(i - chunkStart) / (float)chunkLen;
-                float segmentHue = std::fmod(hue + progress * 0.3f, 1.0f);
+    // One bar per fill bucket, scaled to the busiest bucket
+    juce::uint32 busiest = 1;
+    for (auto count : stats.fillHistogram)
+        busiest = std::max(busiest, count);
 
-                g.setColour(juce::Colour::fromHSV(segmentHue, sat, val, 1.0f));
+    const float barWidth = (float)area.getWidth() / (float)FifoTelemetry::numFillBuckets;
+    const auto bars = area.toFloat();
 
-                juce::Line<float> line(points[i], points[i + 1]);
-                g.drawLine(line, thickness);
-            }
-        }
+    for (int i = 0; i < FifoTelemetry::numFillBuckets; ++i)
+    {
+        const float h = bars.getHeight() * (float)stats.fillHistogram[(size_t)i] / (float)busiest;
+        g.setColour(i == FifoTelemetry::numFillBuckets - 1 ? juce::Colours::red : juce::Colours::green);
+        g.fillRect(bars.getX() + (float)i * barWidth + 1.0f, bars.getBottom() - h, barWidth - 2.0f, h);
     }
 }
-//==============================================================================
-XYscopeAudioProcessorEditor::XYscopeAudioProcessorEditor(XYscopeAudioProcessor& p)
-    : AudioProcessorEditor(&p),
-    processor(p)
+
+void XYscopeAudioProcessorEditor::drawProfilerOverlay(juce::Graphics& g)
 {
-    setSize(600, 600);
+    // Percentiles over the last few seconds of frames
+    const auto records = renderer.getProfiler().getRecords(240);
 
-    setResizable(true, true);
-    setResizeLimits(300, 300, 2400, 2400); // pick sensible max for your display
+    auto area = getLocalBounds().reduced(8).removeFromTop(196).removeFromRight(250);
+    g.setColour(juce::Colours::black.withAlpha(0.7f));
+    g.fillRect(area);
 
-    startTimerHz(60);
+    area = area.reduced(6);
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::FontOptions(12.0f));
 
-}
+    auto row = [&](const juce::String& name, const juce::String& p50, const juce::String& p95, const juce::String& p99)
+        {
+            auto line = area.removeFromTop(15);
+            g.drawText(name, line.removeFromLeft(88), juce::Justification::centredLeft);
 
+            for (auto* text : { &p50, &p95, &p99 })
+                g.drawText(*text, line.removeFromLeft(50), juce::Justification::centredRight);
+        };
 
+    if (records.empty())
+    {
+        row("no frames yet", {}, {}, {});
+        return;
+    }
 
-XYscopeAudioProcessorEditor::~XYscopeAudioProcessorEditor()
-{
+    const auto& last = records.back();
+    row(juce::String(last.width) + " x " + juce::String(last.height), "p50", "p95", "p99");
+
+    std::vector<float> values(records.size());
+
+    auto percentiles = [&](const juce::String& name, auto getValue)
+        {
+            for (size_t i = 0; i < records.size(); ++i)
+                values[i] = getValue(records[i]);
+
+            row(name, juce::String(FrameProfiler::getPercentile(values, 0.5f), 2),
+                      juce::String(FrameProfiler::getPercentile(values, 0.95f), 2),
+                      juce::String(FrameProfiler::getPercentile(values, 0.99f), 2));
+        };
+
+    for (int stage = 0; stage < FrameProfiler::numStages; ++stage)
+        percentiles(FrameProfiler::getStageName(stage), [stage](const FrameProfiler::Record& r) { return r.stageMs[(size_t)stage]; });
+
+    percentiles("render total", [](const FrameProfiler::Record& r) { return r.totalMs; });
+
+    row("ms, " + juce::String(records.size()) + " frames", {}, {}, {});
+    row("scale " + juce::String(last.renderScale, 2) + ", " + juce::String(last.samples) + " samples", {}, {}, {});
 }
 
-//==============================================================================
-void XYscopeAudioProcessorEditor::paint(juce::Graphics& g)
+void XYscopeAudioProcessorEditor::saveFrameProfile()
 {
-    g.fillAll(juce::Colours::black);
+    // Copied now, so the file holds what was recorded when it was asked for
+    auto records = std::make_shared<std::vector<FrameProfiler::Record>>(renderer.getProfiler().getRecords());
 
-    if (accumulation.isValid())
-        g.drawImageAt(accumulation, 0, 0);
-}
+    fileChooser = std::make_unique<juce::FileChooser>("Save frame timings",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("XYscope frame timings.csv"),
+        "*.csv");
+
+    fileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                                 | juce::FileBrowserComponent::warnAboutOverwriting,
+                             [records](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
 
+            if (file == juce::File())
+                return;
+
+            juce::FileOutputStream out(file);
+
+            if (out.openedOk())
+            {
+                out.setPosition(0);
+                out.truncate();
+                FrameProfiler::writeCsv(*records, out);
+            }
+        });
+}
 
 void XYscopeAudioProcessorEditor::resized()
 {
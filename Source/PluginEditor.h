@@ -1,11 +1,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "RenderScheduler.h"
+#include "ScopeRenderer.h"
+#include "OpenGLScopeCanvas.h"
 
 class XYscopeAudioProcessor; // forward declare
 
 class XYscopeAudioProcessorEditor : public juce::AudioProcessorEditor,
-    private juce::Timer
+    private RenderScheduler::Client,
+    private juce::AudioProcessorListener
 {
 public:
     explicit XYscopeAudioProcessorEditor(XYscopeAudioProcessor&);
@@ -13,20 +17,61 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
-    float visualGainSmoothed = 1.0f;
-    float colourEnergySmoothed = 0.0f;
-    float hueAccumulator = 0.0f;
-    float dcPhase = 0.0f;
+    bool keyPressed(const juce::KeyPress&) override;
+    void mouseDown(const juce::MouseEvent&) override;
 
 private:
-    void timerCallback() override;
-    void renderFrame();
+    // RenderScheduler::Client
+    bool prepareScheduledFrame(int& pixelArea) override;
+    void renderScheduledFrame() override;
+    void presentScheduledFrame() override;
+
+    // AudioProcessorListener: parameter changes wake an idle scope
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override { wakeRequested.store(true); }
+    void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {}
+
+    void drawFifoOverlay(juce::Graphics&);
+    void drawTileLabels(juce::Graphics&);
+    void drawProfilerOverlay(juce::Graphics&);
+    void saveFrameProfile();
+    void showOverlayMenu();
+    void updateCanvas();
+    bool isDrawingWithOpenGL() const noexcept { return glCanvas != nullptr && glCanvas->isReady(); }
+    juce::Array<ScopeStream::Ptr> findOverlayStreams() const;
 
     XYscopeAudioProcessor& processor;
 
-    juce::Image accumulation;
-    std::vector<float> scratchL, scratchR;
-    std::vector<juce::Point<float>> points;
+    ScopeRenderer renderer;
+    juce::SharedResourcePointer<RenderScheduler> scheduler;
+    juce::SharedResourcePointer<ScopeRegistry> registry;
+
+    // Other instances the user picked from the right-click menu; applied to
+    // the renderer in prepareScheduledFrame(), when no frame is in flight
+    juce::Array<int> overlayIds;
+    bool overlaysChanged = false;
+
+    // Size captured on the message thread for the next scheduled frame
+    std::atomic<int> renderWidth{ 0 }, renderHeight{ 0 };
+
+    // GPU backend, while enabled and working; the renderer falls back to its
+    // software canvas otherwise
+    std::unique_ptr<OpenGLScopeCanvas> glCanvas;
+    bool openGLUnavailable = false; // shaders failed: for good
+    juce::String openGLError;       // why, for the menu
+    bool openGLTimedOut = false;    // no context in time: until shown again
+
+    // Frames are paced by this window's display refresh
+    juce::VBlankAttachment vblank;
+
+    // While the renderer is idle, frames are skipped until new signal arrives
+    // or something else changes what would be drawn
+    std::atomic<bool> wakeRequested{ true };
+
+    bool scopeAttached = false;   // holding a viewer reference on the processor
+    bool showFifoOverlay = false; // 'D' toggles the scope ring debug overlay
+    bool showProfiler = false;    // 'P' toggles the frame timing overlay
+
+    std::unique_ptr<juce::FileChooser> fileChooser;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(XYscopeAudioProcessorEditor)
 };
@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "SampleConversion.h"
 
 //==============================================================================
 juce::AudioProcessorValueTreeState::ParameterLayout
@@ -29,7 +30,12 @@ XYscopeAudioProcessor::createParameterLayout()
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "persistence", "Tracer",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.85f));
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.85f,
+        juce::AudioParameterFloatAttributes().withStringFromValueFunction([](float value, int)
+            {
+                const double halfLife = getTracerHalfLifeMs(value);
+                return std::isfinite(halfLife) ? juce::String(juce::roundToInt(halfLife)) + " ms" : juce::String("Hold");
+            })));
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "saturation", "Saturate",
@@ -67,11 +73,11 @@ XYscopeAudioProcessor::createParameterLayout()
         juce::NormalisableRange<float>(1.0f, 15.0f, 0.1f), 5.0f));
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        "particleMode", "Wave/Particle",
+        "particleMode", "Wave/Particle", // superseded by renderMode, kept for automation recorded against it
         juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        "fftMode", "FFT Color Mode",
+        "fftMode", "FFT Color Mode", // superseded by colourMode, kept for automation recorded against it
         juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -82,6 +88,30 @@ XYscopeAudioProcessor::createParameterLayout()
         "invertColors", "Invert",
         juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
 
+    // Channel pairs of multichannel layouts; only the first is on by default
+    for (int pair = 0; pair < maxChannelPairs; ++pair)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            "pair" + juce::String(pair + 1), "Pair " + juce::String(pair + 1),
+            juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), pair == 0 ? 1.0f : 0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "pairView", "Pair View", // 0 = overlaid, 1 = tiled
+        juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f), 0.0f));
+
+    // New parameters go last, so hosts that address parameters by index keep
+    // their automation
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "colourMode", "Color Mode", // 0 = energy, 1 = FFT, 2 = crossover
+        juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "renderMode", "Render Mode", // 0 = lines, 1 = particles, 2 = phosphor
+        juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "phosphorCurve", "Phosphor Curve", // 0 = linear, 1 = strongly logarithmic
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
+
     return { params.begin(), params.end() };
 }
 
@@ -115,16 +145,31 @@ XYscopeAudioProcessor::XYscopeAudioProcessor()
     glowIntensityParam = apvts.getRawParameterValue("glowIntensity");  
     glowSizeParam = apvts.getRawParameterValue("glowSize");
     particleModeParam = apvts.getRawParameterValue("particleMode");
+    renderModeParam = apvts.getRawParameterValue("renderMode");
+    phosphorCurveParam = apvts.getRawParameterValue("phosphorCurve");
     fftModeParam = apvts.getRawParameterValue("fftMode");
+    colourModeParam = apvts.getRawParameterValue("colourMode");
     dcOffsetParam = apvts.getRawParameterValue("dcOffset");         
     invertColorsParam = apvts.getRawParameterValue("invertColors");
 
-    ringL.resize(ringSize);
-    ringR.resize(ringSize);
+    for (int pair = 0; pair < maxChannelPairs; ++pair)
+        pairParams[(size_t)pair] = apvts.getRawParameterValue("pair" + juce::String(pair + 1));
+
+    pairViewParam = apvts.getRawParameterValue("pairView");
+
+    // Publish our scope so other instances' editors can overlay it
+    scopeStream = new ScopeStream(numScopeChannels, ringSize, JucePlugin_Name);
+    updateChannelPairs();
+    scopeRegistry->add(scopeStream.get());
 }
 
 XYscopeAudioProcessor::~XYscopeAudioProcessor()
 {
+    analysis.setSource(nullptr);
+
+    // Editors overlaying us may still hold the stream; it just stops receiving samples
+    scopeRegistry->remove(scopeStream.get());
+    scopeStream->markOrphaned();
 }
 
 //==============================================================================
@@ -192,14 +237,42 @@ void XYscopeAudioProcessor::changeProgramName (int index, const juce::String& ne
 //==============================================================================
 void XYscopeAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
+    // Band edges and FFT size follow the host sample rate
+    analysis.prepare(sampleRate);
+    crossover.prepare(sampleRate);
+    fifoTelemetry.prepare(sampleRate, ringSize);
+
+    // Scratch for the crossover envelopes and double->float conversion;
+    // larger host blocks are processed in pieces
+    const auto scratchSize = (size_t)juce::jmax(samplesPerBlock, 512);
+    monoScratch.resize(scratchSize);
+
+    for (auto& channel : conversionScratch)
+        channel.resize(scratchSize);
+
+    for (auto& band : bandScratch)
+        band.resize(scratchSize);
+
+    updateChannelPairs();
+}
+
+void XYscopeAudioProcessor::numChannelsChanged()
+{
+    updateChannelPairs();
+}
+
+void XYscopeAudioProcessor::updateChannelPairs()
+{
+    const int numPairs = juce::jlimit(1, maxChannelPairs, (getTotalNumInputChannels() + 1) / 2);
+    numChannelPairs.store(numPairs);
+
+    if (scopeStream != nullptr)
+        scopeStream->setNumChannels(getNumScopeChannels(numPairs));
 }
 
 void XYscopeAudioProcessor::releaseResources()
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    analysis.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -209,12 +282,11 @@ bool XYscopeAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Mono, stereo and multichannel layouts up to maxChannelPairs pairs; the
+    // extra channels are viewed pair by pair rather than with more instances
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+
+    if (mainOutput.isDisabled() || mainOutput.size() > 2 * maxChannelPairs)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -231,83 +303,138 @@ bool XYscopeAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 void XYscopeAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processScopeBlock(buffer);
+}
 
-    auto numSamples = buffer.getNumSamples();
-    auto* left = buffer.getReadPointer(0);
-    auto* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : left;
+void XYscopeAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processScopeBlock(buffer);
+}
 
-    // Push raw samples for visualization; apply gain/zoom in the editor.
-    pushSamples(left, right, numSamples);
+template <typename SampleType>
+void XYscopeAudioProcessor::processScopeBlock(juce::AudioBuffer<SampleType>& buffer)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // In case we have more outputs than inputs, this code clears any output
+    // channels that didn't contain input data, (because these aren't
+    // guaranteed to be empty - they may contain garbage).
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    // Nobody is looking: no pushing, no analysis, no crossover
+    if (! scopeStream->beginWrite())
+        return;
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), 2 * maxChannelPairs);
+
+    if (numChannels > 0)
+        pushScopeData(buffer.getArrayOfReadPointers(), numChannels, buffer.getNumSamples());
+
+    scopeStream->endWrite();
+}
 
-    // ADD FFT ANALYSIS:
-    for (int i = 0; i < numSamples; ++i)
+template <typename SampleType>
+void XYscopeAudioProcessor::pushScopeData(const SampleType* const* input, int numInputChannels, int numSamples)
+{
+    const int colourMode = getColourMode();
+    const bool withBands = colourMode == crossoverColour;
+    const bool isFloat = std::is_same_v<SampleType, float>;
+
+    // The analysis worker reads the scope ring itself; it idles unless FFT colour is in use
+    analysis.setActive(colourMode == fftColour);
+
+    // Other instances overlaying us draw the same pairs we do
+    const auto pairMask = getEnabledPairMask();
+    scopeStream->setPairMask(pairMask);
+
+    // Float input without bands goes straight in; double input and band
+    // envelopes need scratch space and are processed in pieces
+    const int maxChunk = (isFloat && ! withBands) ? numSamples : (int)monoScratch.size();
+
+    if (maxChunk <= 0)
+        return;
+
+    for (int offset = 0; offset < numSamples; offset += maxChunk)
     {
-        float mono = (left[i] + right[i]) * 0.5f;
+        const int num = juce::jmin(maxChunk, numSamples - offset);
+        const float* channels[numScopeChannels] = {};
 
-        if (fftPos < fftSize)
+        // Gather every selected pair into one ring write. The first pair is
+        // always written: it feeds the analysis worker and the band envelopes.
+        for (int pair = 0; pair < maxChannelPairs; ++pair)
         {
-            fftData[fftPos] = mono;
-            fftData[fftPos + fftSize] = 0.0f; // imaginary part
-            ++fftPos;
+            const int leftIndex = 2 * pair;
+
+            if (leftIndex >= numInputChannels || (pair > 0 && (pairMask & (1u << pair)) == 0))
+                continue;
+
+            const int rightIndex = juce::jmin(leftIndex + 1, numInputChannels - 1);
+            const int dest = getPairChannel(pair);
+
+            channels[dest] = SampleConversion::asFloat(input[leftIndex] + offset, conversionScratch[(size_t)leftIndex].data(), num);
+            channels[dest + 1] = rightIndex == leftIndex ? channels[dest]
+                                                         : SampleConversion::asFloat(input[rightIndex] + offset, conversionScratch[(size_t)rightIndex].data(), num);
         }
 
-        if (fftPos >= fftSize)
+        if (withBands)
         {
-            // Perform FFT
-            fft.performFrequencyOnlyForwardTransform(fftData.data());
+            // Per-sample band envelopes travel through the FIFO next to L/R
+            juce::FloatVectorOperations::copy(monoScratch.data(), channels[leftChannel], num);
+            juce::FloatVectorOperations::add(monoScratch.data(), channels[rightChannel], num);
+            juce::FloatVectorOperations::multiply(monoScratch.data(), 0.5f, num);
 
-            // Analyze frequency bands
-            float bass = 0.0f, mid = 0.0f, high = 0.0f;
+            crossover.process(monoScratch.data(), bandScratch[0].data(), bandScratch[1].data(), bandScratch[2].data(), num);
+
+            channels[bassChannel] = bandScratch[0].data();
+            channels[midChannel] = bandScratch[1].data();
+            channels[highChannel] = bandScratch[2].data();
+        }
+
+        // Push raw samples for visualization; apply gain/zoom in the editor.
+        pushSamples(channels, num);
+    }
+}
 
-            // Bass: 20-250 Hz (bins 0-12 at 44.1kHz)
-            for (int bin = 0; bin < 13; ++bin)
-                bass += fftData[bin];
-            bass /= 13.0f;
+//==============================================================================
+void XYscopeAudioProcessor::attachScopeViewer()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
 
-            // Mids: 250-2000 Hz (bins 13-100)
-            for (int bin = 13; bin < 100; ++bin)
-                mid += fftData[bin];
-            mid /= 87.0f;
+    if (scopeViewers++ > 0)
+        return;
 
-            // Highs: 2000+ Hz (bins 100-512)
-            for (int bin = 100; bin < fftSize / 2; ++bin)
-                high += fftData[bin];
-            high /= (fftSize / 2 - 100);
+    // If another instance is already overlaying us the audio thread is running
+    // the crossover, so only start it from a clean state when nobody was
+    if (! scopeStream->hasViewers())
+        crossover.reset();
 
-            // Store normalized values
-            bassEnergy.store(juce::jlimit(0.0f, 1.0f, bass * 0.1f));
-            midEnergy.store(juce::jlimit(0.0f, 1.0f, mid * 0.1f));
-            highEnergy.store(juce::jlimit(0.0f, 1.0f, high * 0.1f));
+    scopeStream->attachViewer();
 
-            fftPos = 0;
-        }
-    }
+    // Whatever overlaying editors kept the ring filling with before we came
+    // is no backlog of ours
+    scopeStream->getRing()->skipToNewest();
+    fifoTelemetry.reset();
+    analysis.setSource(scopeStream->getRing());
+}
 
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+void XYscopeAudioProcessor::detachScopeViewer()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
 
-    // In case we have more outputs than inputs, this code clears any output
-    // channels that didn't contain input data, (because these aren't
-    // guaranteed to be empty - they may contain garbage).
-    // This is here to avoid people getting screaming feedback
-    // when they first compile a plugin, but obviously you don't need to keep
-    // this code if your algorithm always overwrites all the output channels.
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+    jassert(scopeViewers > 0);
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* channelData = buffer.getWritePointer (channel);
+    if (--scopeViewers > 0)
+        return;
 
-        // ..do something to the data...
-    }
+    analysis.setActive(false);
+    analysis.setSource(nullptr);
+    fifoTelemetry.pause();
+    scopeStream->detachViewer();
 }
 
 //==============================================================================
@@ -333,8 +460,32 @@ void XYscopeAudioProcessor::setStateInformation(const void* data, int sizeInByte
 {
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml.get() != nullptr)
+    {
         if (xml->hasTagName(apvts.state.getType()))
-            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        {
+            auto state = juce::ValueTree::fromXml(*xml);
+            migrateModeParameter(state, "fftMode", "colourMode");
+            migrateModeParameter(state, "particleMode", "renderMode");
+            apvts.replaceState(state);
+        }
+    }
+}
+
+void XYscopeAudioProcessor::migrateModeParameter(juce::ValueTree& state, const juce::String& oldId, const juce::String& newId)
+{
+    // Sessions saved before newId existed keep their mode in oldId: move it
+    // over, leaving oldId at its default so it doesn't hold the mode as well
+    auto oldParam = state.getChildWithProperty("id", oldId);
+
+    if (! oldParam.isValid() || state.getChildWithProperty("id", newId).isValid())
+        return;
+
+    juce::ValueTree newParam("PARAM");
+    newParam.setProperty("id", newId, nullptr);
+    newParam.setProperty("value", oldParam.getProperty("value"), nullptr);
+    state.appendChild(newParam, nullptr);
+
+    oldParam.setProperty("value", 0.0f, nullptr);
 }
 
 //==============================================================================
@@ -345,43 +496,97 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 }
 
 //==============================================================================
-void XYscopeAudioProcessor::pushSamples(const float* left, const float* right, int numSamples)
+juce::uint32 XYscopeAudioProcessor::getEnabledPairMask() const noexcept
 {
-    int start1, size1, start2, size2;
-    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    // A ring allocated before the layout grew only has room for the pairs it had
+    juce::uint32 mask = 0;
+    const int numPairs = juce::jmin(getNumChannelPairs(), getNumScopePairs(scopeStream->getNumChannels()));
 
-    if (size1 > 0)
-    {
-        std::memcpy(ringL.data() + start1, left, (size_t)size1 * sizeof(float));
-        std::memcpy(ringR.data() + start1, right, (size_t)size1 * sizeof(float));
-    }
+    for (int pair = 0; pair < numPairs; ++pair)
+        if (pairParams[(size_t)pair] != nullptr && pairParams[(size_t)pair]->load() > 0.5f)
+            mask |= 1u << pair;
 
-    if (size2 > 0)
-    {
-        std::memcpy(ringL.data() + start2, left + size1, (size_t)size2 * sizeof(float));
-        std::memcpy(ringR.data() + start2, right + size1, (size_t)size2 * sizeof(float));
-    }
+    return mask;
+}
+
+double XYscopeAudioProcessor::getTracerHalfLifeMs(float persist) noexcept
+{
+    if (persist <= 0.0f)
+        return 0.0;
+
+    if (persist >= 1.0f)
+        return std::numeric_limits<double>::infinity();
 
-    fifo.finishedWrite(size1 + size2);
+    // persist^(t / frame) = 0.5  ->  t = frame * ln 0.5 / ln persist
+    return tracerReferenceFrameMs * std::log(0.5) / std::log((double)persist);
 }
 
-int XYscopeAudioProcessor::pullSamples(float* destL, float* destR, int maxSamples)
+juce::String XYscopeAudioProcessor::getChannelPairName(int pair) const
 {
-    int start1, size1, start2, size2;
-    fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+    const auto layout = getTotalNumInputChannels() > 0 ? getChannelLayoutOfBus(true, 0)
+                                                       : getChannelLayoutOfBus(false, 0);
 
-    if (size1 > 0)
-    {
-        std::memcpy(destL, ringL.data() + start1, (size_t)size1 * sizeof(float));
-        std::memcpy(destR, ringR.data() + start1, (size_t)size1 * sizeof(float));
-    }
+    auto channelName = [&layout](int index) -> juce::String
+        {
+            if (index >= layout.size())
+                return {};
+
+            return juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(index));
+        };
 
-    if (size2 > 0)
+    const auto left = channelName(2 * pair);
+    const auto right = channelName(2 * pair + 1);
+
+    if (left.isEmpty())
+        return "Pair " + juce::String(pair + 1);
+
+    return right.isEmpty() ? left : left + "/" + right;
+}
+
+void XYscopeAudioProcessor::pushSamples(const float* const* channels, int numSamples)
+{
+    auto* ring = scopeStream->getRing();
+    jassert(ring != nullptr); // only called between beginWrite() and endWrite()
+    ring->write(channels, numSamples);
+    fifoTelemetry.recordPush(numSamples, ring->getNumPending());
+
+    // Only the pair channels count: band envelopes follow from them
+    for (int pair = 0; pair < maxChannelPairs; ++pair)
     {
-        std::memcpy(destL + size1, ringL.data() + start2, (size_t)size2 * sizeof(float));
-        std::memcpy(destR + size1, ringR.data() + start2, (size_t)size2 * sizeof(float));
+        const int channel = getPairChannel(pair);
+
+        if (isAudible(channels[channel], numSamples) || isAudible(channels[channel + 1], numSamples))
+        {
+            scopeStream->noteSignal();
+            break;
+        }
     }
+}
+
+bool XYscopeAudioProcessor::isAudible(const float* samples, int numSamples) noexcept
+{
+    if (samples == nullptr)
+        return false;
+
+    const auto range = juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+    return juce::jmax(-range.getStart(), range.getEnd()) > silenceLevel;
+}
+
+int XYscopeAudioProcessor::pullSamples(float* const* dest, int maxSamples)
+{
+    auto* ring = scopeStream->getRing();
+
+    if (ring == nullptr)
+        return 0;
 
-    fifo.finishedRead(size1 + size2);
-    return size1 + size2;
+    juce::uint64 skipped = 0;
+    const int got = ring->readNew(dest, maxSamples, &skipped);
+    fifoTelemetry.recordRead(got, skipped);
+    return got;
+}
+
+int XYscopeAudioProcessor::copyLatestSamples(float* const* dest, int numSamples) const
+{
+    auto* ring = scopeStream->getRing();
+    return ring != nullptr ? ring->readLatest(dest, numSamples) : 0;
 }
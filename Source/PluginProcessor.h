@@ -2,6 +2,11 @@
 
 #include <JuceHeader.h>
 #include <array>
+#include "AnalysisEngine.h"
+#include "CrossoverFilterbank.h"
+#include "ScopeRing.h"
+#include "ScopeRegistry.h"
+#include "FifoTelemetry.h"
 
 //==============================================================================
 class XYscopeAudioProcessor : public juce::AudioProcessor
@@ -19,7 +24,14 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 #endif
 
+    void numChannelsChanged() override;
+
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // 64-bit hosts hand us their buffers directly; samples are converted to
+    // the scope ring's float format on the way in
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -63,28 +75,167 @@ public:
     std::atomic<float>* glowIntensityParam = nullptr;  
     std::atomic<float>* glowSizeParam = nullptr;
     std::atomic<float>* particleModeParam = nullptr;
+    std::atomic<float>* renderModeParam = nullptr;
+    std::atomic<float>* phosphorCurveParam = nullptr;
     std::atomic<float>* fftModeParam = nullptr;
+    std::atomic<float>* colourModeParam = nullptr;
     std::atomic<float>* dcOffsetParam = nullptr;    
     std::atomic<float>* invertColorsParam = nullptr;       
 
-    // ---- Scope FIFO (audio thread -> UI thread) ----
-    static constexpr int ringSize = 1 << 17; // 131072 samples
-    juce::AbstractFifo fifo{ ringSize };
-    std::vector<float> ringL, ringR;
-
-    void pushSamples(const float* left, const float* right, int numSamples);
-    int  pullSamples(float* destL, float* destR, int maxSamples);
-    std::atomic<float> bassEnergy{ 0.0f };
-    std::atomic<float> midEnergy{ 0.0f };
-    std::atomic<float> highEnergy{ 0.0f };
+    // Editor preferences, saved with the plugin state (message thread)
+    bool isOpenGLEnabled() const { return (bool)apvts.state.getProperty("useOpenGL", false); }
+    void setOpenGLEnabled(bool shouldUseOpenGL) { apvts.state.setProperty("useOpenGL", shouldUseOpenGL, nullptr); }
+
+    // Render time per frame the editor's quality governor aims for; 0 = always
+    // full quality. Off unless picked, so sessions never drop quality unasked.
+    static constexpr double defaultFrameBudgetMs = 0.0;
+    double getFrameBudgetMs() const { return (double)apvts.state.getProperty("frameBudgetMs", defaultFrameBudgetMs); }
+    void setFrameBudgetMs(double budgetMs) { apvts.state.setProperty("frameBudgetMs", budgetMs, nullptr); }
+
+    // Points per frame the editor resamples each trace to, whatever the sample
+    // rate; 0 = every sample as it comes. Off unless picked, so sessions keep
+    // the look they were made with.
+    static constexpr int defaultPointBudget = 0;
+    int getPointBudget() const { return (int)apvts.state.getProperty("pointBudget", defaultPointBudget); }
+    void setPointBudget(int numPoints) { apvts.state.setProperty("pointBudget", numPoints, nullptr); }
+
+    // ---- Channel pairs ----
+    // Multichannel layouts are viewed as consecutive channel pairs in the
+    // bus's channel order (L/R, C/LFE, Ls/Rs, ...); pairN toggles pair N.
+    static constexpr int maxChannelPairs = 8; // 16 channels covers 7.1.4 and 9.1.6
+    std::array<std::atomic<float>*, maxChannelPairs> pairParams{};
+    std::atomic<float>* pairViewParam = nullptr;
+
+    enum PairView { overlayPairs = 0, tiledPairs = 1 };
+    int getPairView() const noexcept { return pairViewParam != nullptr ? juce::roundToInt(pairViewParam->load()) : overlayPairs; }
+
+    int getNumChannelPairs() const noexcept { return numChannelPairs.load(std::memory_order_relaxed); }
+
+    // Bit N set: pair N exists in the current layout and is switched on
+    juce::uint32 getEnabledPairMask() const noexcept;
+
+    // Message thread, e.g. "Ls/Rs"
+    juce::String getChannelPairName(int pair) const;
+
+    // Values of the colourMode ("Color Mode") parameter. The older fftMode
+    // switch still selects FFT colour while colourMode is left at energy, so
+    // automation recorded against it plays back as it was recorded.
+    enum ColourMode { energyColour = 0, fftColour = 1, crossoverColour = 2 };
+    int getColourMode() const noexcept
+    {
+        const int mode = colourModeParam != nullptr ? juce::roundToInt(colourModeParam->load()) : energyColour;
+
+        if (mode == energyColour && fftModeParam != nullptr && fftModeParam->load() > 0.5f)
+            return fftColour;
+
+        return mode;
+    }
+
+    // Values of the renderMode ("Render Mode") parameter; the older
+    // particleMode switch still selects particles while renderMode is lines
+    enum RenderMode { lineRender = 0, particleRender = 1, phosphorRender = 2 };
+    int getRenderMode() const noexcept
+    {
+        const int mode = renderModeParam != nullptr ? juce::roundToInt(renderModeParam->load()) : lineRender;
+
+        if (mode == lineRender && particleModeParam != nullptr && particleModeParam->load() > 0.5f)
+            return particleRender;
+
+        return mode;
+    }
+
+    // "Tracer" is the share of light a trail keeps per frame at 60 Hz. The
+    // renderer decays by half-life instead, so trails last equally long at
+    // any frame rate; 0 means no trail, infinity a trail that never fades.
+    static constexpr double tracerReferenceFrameMs = 1000.0 / 60.0;
+    static double getTracerHalfLifeMs(float persist) noexcept;
+
+    // ---- Scope ring (audio thread -> UI thread) ----
+    // Overwrites the oldest samples when full, so the editor always draws the
+    // present; it only has to cover a few frames at the highest sample rate.
+    static constexpr int ringSize = 1 << 15; // 32768 samples
+    static constexpr int numBands = 3; // bass, mid, high envelopes (crossover colour mode)
+
+    // The first pair shares the ring with the band envelopes of its downmix;
+    // further pairs follow, two channels each
+    enum ScopeChannel { leftChannel, rightChannel, bassChannel, midChannel, highChannel, firstExtraPairChannel,
+                        numScopeChannels = firstExtraPairChannel + 2 * (maxChannelPairs - 1) };
+
+    // Ring channel holding the left side of a pair; the right side follows it
+    static constexpr int getPairChannel(int pair) noexcept { return pair == 0 ? leftChannel : firstExtraPairChannel + 2 * (pair - 1); }
+
+    // Ring channels that hold numPairs pairs, and the pairs numChannels hold.
+    // Rings are sized to the bus, so a stereo instance carries 5 channels, not 19.
+    static constexpr int getNumScopeChannels(int numPairs) noexcept { return numPairs <= 1 ? firstExtraPairChannel : getPairChannel(numPairs - 1) + 2; }
+    static constexpr int getNumScopePairs(int numChannels) noexcept { return numChannels <= firstExtraPairChannel ? 1 : 1 + (numChannels - firstExtraPairChannel) / 2; }
+
+    // Message thread. While no viewer is attached (our own editor or another
+    // instance overlaying this one) processBlock skips all scope work and the
+    // ring storage is released.
+    void attachScopeViewer();
+    void detachScopeViewer();
+    bool isScopeAttached() const noexcept { return scopeStream->hasViewers(); }
+
+    // This instance's entry in the process-wide ScopeRegistry
+    ScopeStream::Ptr getScopeStream() const noexcept { return scopeStream; }
+
+    // All of these take numScopeChannels pointers, indexed by ScopeChannel.
+    // Null channels are pushed as silence and skipped when pulling. Blocks
+    // with any pair channel above silenceLevel count as signal (see
+    // ScopeStream::noteSignal), which is what wakes idle editors.
+    void pushSamples(const float* const* channels, int numSamples);
+    static constexpr float silenceLevel = 1.0e-5f; // -100 dBFS
+
+    // Samples pushed since the last pull; only the newest maxSamples if more are waiting
+    int  pullSamples(float* const* dest, int maxSamples);
+
+    // Non-consuming copy of the most recent numSamples
+    int  copyLatestSamples(float* const* dest, int numSamples) const;
+
+    // Overruns (dropped samples), underruns (short reads) and fill levels of the scope ring
+    FifoTelemetry::Snapshot getFifoStats() const noexcept { return fifoTelemetry.getSnapshot(); }
+    void resetFifoStats() noexcept { fifoTelemetry.reset(); }
+
+    // The main consumer has stopped pulling for now (e.g. its renderer is
+    // idle); its next pull resumes the stats without counting the backlog
+    void pauseFifoStats() noexcept { fifoTelemetry.pause(); }
+
+    // ---- FFT band analysis (worker thread -> UI thread) ----
+    BandEnergies getBandEnergies() const noexcept { return analysis.getBandEnergies(); }
+    bool isAnalysisActive() const noexcept { return analysis.isActive(); }
+
+    // Offline rendering: no analysis worker; updateAnalysis() catches the
+    // bands up with everything pushed so far, on the calling thread
+    void setOfflineAnalysis(bool shouldBeOffline) { analysis.setOffline(shouldBeOffline); }
+    void updateAnalysis() { analysis.update(); }
 
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(XYscopeAudioProcessor)
 
-        // ADD THESE FFT members:
-        static constexpr int fftOrder = 10;
-    static constexpr int fftSize = 1 << fftOrder; // 1024
-    juce::dsp::FFT fft{ fftOrder };
-    std::array<float, fftSize * 2> fftData;
-    int fftPos = 0;
+    template <typename SampleType>
+    void processScopeBlock(juce::AudioBuffer<SampleType>&);
+
+    template <typename SampleType>
+    void pushScopeData(const SampleType* const* input, int numInputChannels, int numSamples);
+
+    static bool isAudible(const float* samples, int numSamples) noexcept;
+
+    // Pairs of the current bus layout, and the ring size future viewers get
+    void updateChannelPairs();
+
+    // setStateInformation(): moves an old mode parameter's value to the one that replaced it
+    static void migrateModeParameter(juce::ValueTree& state, const juce::String& oldId, const juce::String& newId);
+
+    juce::SharedResourcePointer<ScopeRegistry> scopeRegistry;
+    ScopeStream::Ptr scopeStream;
+    int scopeViewers = 0;
+
+    AnalysisEngine analysis;
+    FifoTelemetry fifoTelemetry;
+
+    CrossoverFilterbank crossover;
+    std::vector<float> monoScratch;
+    std::array<std::vector<float>, 2 * maxChannelPairs> conversionScratch; // float copies of double input
+    std::atomic<int> numChannelPairs{ 1 };
+    std::array<std::vector<float>, numBands> bandScratch;
 };
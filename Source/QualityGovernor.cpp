@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    Adaptive render quality against a frame time budget.
+
+  ==============================================================================
+*/
+
+#include "QualityGovernor.h"
+
+namespace
+{
+    // Smoothing of the measured stage costs, per frame
+    constexpr double costSmoothing = 0.1;
+
+    // Frames to let the smoothed costs catch up after a step, before judging again
+    constexpr int framesToSettle = 20;
+
+    // Restoring quality needs this many frames in a row below restoreBelow of
+    // the budget, and an estimated cost afterwards below restoreFit of it
+    constexpr int calmFramesToRestore = 60;
+    constexpr double restoreBelow = 0.6;
+    constexpr double restoreFit = 0.85;
+}
+
+//==============================================================================
+void QualityGovernor::setOptions(bool canScaleResolution, bool hasStrokedGlow) noexcept
+{
+    if (canScaleResolution == scalable && hasStrokedGlow == strokedGlow)
+        return;
+
+    scalable = canScaleResolution;
+    strokedGlow = hasStrokedGlow;
+
+    // What was measured no longer applies: start over from full quality
+    pixelLevel = geometryLevel = 0;
+    changed();
+}
+
+void QualityGovernor::addFrame(double newDrawMs, double newPixelMs) noexcept
+{
+    drawMs += (newDrawMs - drawMs) * costSmoothing;
+    pixelMs += (newPixelMs - pixelMs) * costSmoothing;
+
+    const double budget = budgetMs.load();
+
+    if (budget <= 0.0)
+    {
+        pixelLevel = geometryLevel = 0;
+        return;
+    }
+
+    if (settleFrames > 0)
+    {
+        --settleFrames;
+        return;
+    }
+
+    const int lastPixelLevel = scalable ? (int)renderScales.size() - 1 : 0;
+    const double total = drawMs + pixelMs;
+
+    if (total > budget)
+    {
+        calmFrames = 0;
+
+        // Cheapen whichever stage costs more, or the other once that one is out of steps
+        const int cheaperGeometry = findCheaperGeometryStep(geometryLevel);
+        const bool canCheapenPixels = pixelLevel < lastPixelLevel;
+        const bool canCheapenGeometry = cheaperGeometry != geometryLevel;
+
+        if (canCheapenPixels && (pixelMs >= drawMs || ! canCheapenGeometry))
+            ++pixelLevel;
+        else if (canCheapenGeometry)
+            geometryLevel = cheaperGeometry;
+        else
+            return;
+
+        changed();
+        return;
+    }
+
+    if (total > budget * restoreBelow || (pixelLevel == 0 && geometryLevel == 0))
+    {
+        calmFrames = 0;
+        return;
+    }
+
+    if (++calmFrames < calmFramesToRestore)
+        return;
+
+    calmFrames = 0;
+
+    // Resolution first, as it's the most visible; pixel work goes with the area
+    if (pixelLevel > 0)
+    {
+        const double ratio = renderScales[(size_t)pixelLevel - 1] / renderScales[(size_t)pixelLevel];
+
+        if (drawMs + pixelMs * ratio * ratio < budget * restoreFit)
+        {
+            --pixelLevel;
+            changed();
+            return;
+        }
+    }
+
+    if (geometryLevel > 0)
+    {
+        const int costlier = findCostlierGeometryStep(geometryLevel);
+        const double ratio = getGeometryCost(costlier) / getGeometryCost(geometryLevel);
+
+        if (drawMs * ratio + pixelMs < budget * restoreFit)
+        {
+            geometryLevel = costlier;
+            changed();
+        }
+    }
+}
+
+QualityGovernor::Quality QualityGovernor::getQuality() const noexcept
+{
+    const auto& step = geometrySteps[(size_t)geometryLevel];
+
+    Quality quality;
+    quality.renderScale = renderScales[(size_t)pixelLevel];
+    quality.pointStride = step.pointStride;
+    quality.glowPasses = step.glowPasses;
+    return quality;
+}
+
+void QualityGovernor::changed() noexcept
+{
+    settleFrames = framesToSettle;
+    calmFrames = 0;
+}
+
+//==============================================================================
+double QualityGovernor::getGeometryCost(int step) const noexcept
+{
+    // Strokes drawn per point: the core plus each glow pass, if glow is stroked
+    const auto& s = geometrySteps[(size_t)step];
+    return (strokedGlow ? (double)(s.glowPasses + 1) : 1.0) / (double)s.pointStride;
+}
+
+int QualityGovernor::findCheaperGeometryStep(int step) const noexcept
+{
+    // Steps that only drop glow passes make no difference without stroked glow
+    for (int next = step + 1; next < (int)geometrySteps.size(); ++next)
+        if (getGeometryCost(next) < getGeometryCost(step))
+            return next;
+
+    return step;
+}
+
+int QualityGovernor::findCostlierGeometryStep(int step) const noexcept
+{
+    int costlier = step;
+
+    // The best looking of the steps at the next cost up
+    for (int previous = step - 1; previous >= 0; --previous)
+    {
+        const double cost = getGeometryCost(previous);
+
+        if (costlier == step ? cost > getGeometryCost(step) : cost == getGeometryCost(costlier))
+            costlier = previous;
+        else if (costlier != step)
+            break;
+    }
+
+    return costlier;
+}
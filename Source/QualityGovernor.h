@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+// Trades picture quality for render time to keep each scope's frames inside
+// a budget, whatever the machine, window size or settings.
+//
+// The renderer reports two costs per frame: drawing (pulling samples,
+// transforming and stroking them) and pixel work (fading, bloom and
+// tone-mapping). When their smoothed sum goes over budget the governor
+// cheapens whichever costs more, one step at a time; once frames have been
+// well inside the budget for a while it restores a step, but only if the
+// estimated cost afterwards still fits, so it doesn't oscillate.
+//
+// Two ladders of steps:
+//  - pixels: the internal render resolution, upscaled when presented
+//  - geometry: every Nth point drawn, and fewer stroked glow passes
+class QualityGovernor
+{
+public:
+    struct Quality
+    {
+        float renderScale = 1.0f; // fraction of the window's size rendered
+        int pointStride = 1;      // draw every Nth point
+        int glowPasses = 3;       // stroked glow passes, where glow is stroked
+    };
+
+    QualityGovernor() = default;
+
+    // Any thread. Zero or less turns the governor off: full quality always.
+    void setBudgetMs(double newBudgetMs) noexcept { budgetMs.store(newBudgetMs); }
+    double getBudgetMs() const noexcept { return budgetMs.load(); }
+
+    //==============================================================================
+    // Render thread. What the current canvas makes worth adjusting: rendering
+    // at a lower resolution only helps a canvas that works per pixel on the
+    // CPU, and glow passes only matter where glow is stroked.
+    void setOptions(bool canScaleResolution, bool hasStrokedGlow) noexcept;
+
+    // Render thread, once per frame with that frame's stage costs
+    void addFrame(double drawMs, double pixelMs) noexcept;
+
+    // Render thread. The quality to draw the next frame at.
+    Quality getQuality() const noexcept;
+
+private:
+    struct GeometryStep
+    {
+        int pointStride, glowPasses;
+    };
+
+    static constexpr std::array<float, 5> renderScales{ 1.0f, 0.85f, 0.7f, 0.6f, 0.5f };
+    static constexpr std::array<GeometryStep, 6> geometrySteps{ { { 1, 3 }, { 1, 2 }, { 2, 2 }, { 2, 1 }, { 4, 1 }, { 4, 0 } } };
+
+    // Drawing cost of a geometry step relative to full quality
+    double getGeometryCost(int step) const noexcept;
+    int findCheaperGeometryStep(int step) const noexcept;
+    int findCostlierGeometryStep(int step) const noexcept;
+
+    void changed() noexcept;
+
+    std::atomic<double> budgetMs{ 6.0 };
+
+    double drawMs = 0.0, pixelMs = 0.0; // smoothed stage costs
+    int pixelLevel = 0, geometryLevel = 0;
+    int settleFrames = 0, calmFrames = 0;
+    bool scalable = true, strokedGlow = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QualityGovernor)
+};
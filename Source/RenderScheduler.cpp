@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    Process-wide frame clock and render pool for all open scopes.
+
+  ==============================================================================
+*/
+
+#include "RenderScheduler.h"
+
+namespace
+{
+    int getNumRenderThreads()
+    {
+        return juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 2);
+    }
+
+    // Share of the pool's time per frame we are willing to spend; the rest is
+    // left for the host and the message thread.
+    constexpr double budgetFraction = 0.75;
+
+    // Vblanks closer together than this are the same refresh seen by
+    // several windows
+    constexpr double sameRefreshMs = 2.0;
+
+    // The timer takes over when no vblank has come in for this long
+    constexpr double vblankTimeoutMs = 100.0;
+
+    // Longer gaps between ticks (idle, hidden) say nothing about the refresh rate
+    constexpr double maxRefreshPeriodMs = 50.0;
+}
+
+//==============================================================================
+RenderScheduler::RenderScheduler()
+    : pool(getNumRenderThreads())
+{
+}
+
+RenderScheduler::~RenderScheduler()
+{
+    stopTimer();
+    pool.removeAllJobs(false, 2000);
+}
+
+//==============================================================================
+void RenderScheduler::addClient(Client* client)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto* entry = entries.add(new Entry());
+    entry->client = client;
+
+    if (! isTimerRunning())
+        startTimerHz(fallbackRateHz);
+}
+
+void RenderScheduler::removeClient(Client* client)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    for (auto* entry : entries)
+    {
+        if (entry->client != client)
+            continue;
+
+        // The worker never needs the message thread, so this can't deadlock
+        entry->frameDone.wait(-1);
+
+        order.removeFirstMatchingValue(entry);
+        entries.removeObject(entry);
+        break;
+    }
+
+    if (entries.size() == 0)
+        stopTimer();
+}
+
+//==============================================================================
+void RenderScheduler::handleVBlank()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    const double now = juce::Time::getMillisecondCounterHiRes();
+
+    if (now - lastTickMs < sameRefreshMs)
+        return;
+
+    lastVBlankMs = now;
+    tick();
+}
+
+void RenderScheduler::timerCallback()
+{
+    if (juce::Time::getMillisecondCounterHiRes() - lastVBlankMs > vblankTimeoutMs)
+        tick();
+}
+
+void RenderScheduler::tick()
+{
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const double interval = now - lastTickMs;
+    lastTickMs = now;
+
+    if (interval < maxRefreshPeriodMs)
+        framePeriodMs += (juce::jmax(2.0, interval) - framePeriodMs) * 0.1;
+
+    ++tickCount;
+
+    // Frames finished since the last tick go on screen first
+    for (auto* entry : entries)
+        if (entry->finished.exchange(false))
+            entry->client->presentScheduledFrame();
+
+    order.clearQuick();
+
+    for (auto* entry : entries)
+    {
+        // Still rendering the previous frame: leave it alone this tick
+        if (entry->busy.load())
+        {
+            entry->wantsFrame = false;
+            continue;
+        }
+
+        entry->wantsFrame = entry->client->prepareScheduledFrame(entry->pixelArea);
+
+        if (entry->wantsFrame)
+            order.add(entry);
+    }
+
+    // Visible scopes only, largest first
+    std::sort(order.begin(), order.end(),
+              [](const Entry* a, const Entry* b) { return a->pixelArea > b->pixelArea; });
+
+    updateRateDivisors();
+
+    for (int i = 0; i < order.size(); ++i)
+    {
+        auto* entry = order.getUnchecked(i);
+
+        // Stagger clients running at a reduced rate so they don't all land on the same tick
+        if (((tickCount + (juce::uint32)i) % (juce::uint32)entry->rateDivisor) == 0)
+            dispatch(*entry);
+    }
+}
+
+void RenderScheduler::updateRateDivisors()
+{
+    auto demand = [this]
+        {
+            double total = 0.0;
+
+            for (auto* entry : order)
+                total += entry->lastCostMs.load() / (double)entry->rateDivisor;
+
+            return total;
+        };
+
+    for (auto* entry : order)
+        entry->rateDivisor = 1;
+
+    const double budget = getFrameBudgetMs();
+
+    // Halve the smallest scopes first, then the next smallest, one step at a time
+    while (demand() > budget)
+    {
+        bool slowedAny = false;
+
+        for (int i = order.size(); --i >= 0 && demand() > budget;)
+        {
+            auto* entry = order.getUnchecked(i);
+
+            if (entry->rateDivisor < maxRateDivisor)
+            {
+                entry->rateDivisor *= 2;
+                slowedAny = true;
+            }
+        }
+
+        if (! slowedAny)
+            break;
+    }
+}
+
+void RenderScheduler::dispatch(Entry& entry)
+{
+    entry.frameDone.reset();
+    entry.busy.store(true);
+
+    pool.addJob([e = &entry]
+        {
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            e->client->renderScheduledFrame();
+            const auto cost = juce::Time::getMillisecondCounterHiRes() - start;
+
+            e->lastCostMs.store(e->lastCostMs.load() * 0.8 + cost * 0.2);
+            e->finished.store(true);
+            e->busy.store(false);
+
+            // Last: removeClient() may delete the entry as soon as this is set
+            e->frameDone.signal();
+        });
+}
+
+double RenderScheduler::getFrameBudgetMs() const noexcept
+{
+    return framePeriodMs * (double)pool.getNumThreads() * budgetFraction;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// One frame clock and one small worker pool shared by every open scope in the
+// process (hold it through juce::SharedResourcePointer).
+//
+// Each tick the scheduler asks its clients whether they want a frame,
+// dispatches the visible ones largest first to the pool, and lets finished
+// frames present on the next tick. When the measured render cost of all
+// clients no longer fits the frame budget, the smallest scopes have their
+// rate halved first, then the next smallest, and so on.
+//
+// Ticks follow the display: clients forward their windows' vertical blanks
+// (juce::VBlankAttachment) to handleVBlank(), so frames land on refreshes at
+// whatever rate the monitor runs, and the budget follows the measured
+// refresh period. A timer stands in while no vblank arrives (all windows
+// hidden, or a platform without vblank callbacks).
+class RenderScheduler : private juce::Timer
+{
+public:
+    struct Client
+    {
+        virtual ~Client() = default;
+
+        // Message thread, once per tick but never while a frame of this client
+        // is still rendering. Return false to sit this tick out (hidden,
+        // minimised...); otherwise report the pixel area to draw.
+        virtual bool prepareScheduledFrame(int& pixelArea) = 0;
+
+        // Worker thread. Never called concurrently for the same client.
+        virtual void renderScheduledFrame() = 0;
+
+        // Message thread, the tick after renderScheduledFrame() finished.
+        virtual void presentScheduledFrame() = 0;
+    };
+
+    RenderScheduler();
+    ~RenderScheduler() override;
+
+    // Message thread. removeClient() blocks on an in-flight frame of that
+    // client until it finishes (no polling), so call it before the client
+    // is destroyed.
+    void addClient(Client* client);
+    void removeClient(Client* client);
+
+    // Message thread, from any client's VBlankAttachment. Windows on the same
+    // display all report the same refresh; only the first one ticks.
+    void handleVBlank();
+
+    static constexpr int fallbackRateHz = 60;
+    static constexpr int maxRateDivisor = 8;
+
+private:
+    struct Entry
+    {
+        Entry() { frameDone.signal(); }
+
+        Client* client = nullptr;
+        juce::WaitableEvent frameDone{ true }; // set while no frame is in flight
+        std::atomic<bool> busy{ false };
+        std::atomic<bool> finished{ false };
+        std::atomic<double> lastCostMs{ 0.0 };
+        bool wantsFrame = false;
+        int pixelArea = 0;
+        int rateDivisor = 1;
+    };
+
+    void timerCallback() override;
+    void tick();
+    void updateRateDivisors();
+    void dispatch(Entry& entry);
+
+    double getFrameBudgetMs() const noexcept;
+
+    juce::OwnedArray<Entry> entries;
+    juce::Array<Entry*> order;
+    juce::ThreadPool pool;
+    juce::uint32 tickCount = 0;
+
+    double lastTickMs = 0.0, lastVBlankMs = 0.0;
+    double framePeriodMs = 1000.0 / fallbackRateHz; // smoothed time between ticks
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderScheduler)
+};
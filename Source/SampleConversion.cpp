@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    Double to float conversion for the 64-bit processing path.
+
+  ==============================================================================
+*/
+
+#include "SampleConversion.h"
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
+void SampleConversion::toFloat(float* dest, const double* src, int numSamples) noexcept
+{
+    int i = 0;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    // Two cvtpd_ps per four samples; the halves land in the low lanes
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dest + i, _mm_movelh_ps(lo, hi));
+    }
+   #elif JUCE_USE_ARM_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const float32x2_t lo = vcvt_f32_f64(vld1q_f64(src + i));
+        const float32x2_t hi = vcvt_f32_f64(vld1q_f64(src + i + 2));
+        vst1q_f32(dest + i, vcombine_f32(lo, hi));
+    }
+   #endif
+
+    for (; i < numSamples; ++i)
+        dest[i] = (float)src[i];
+}
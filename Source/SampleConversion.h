@@ -0,0 +1,24 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Bringing host samples into the scope's float storage format.
+namespace SampleConversion
+{
+    // One vectorised pass: dest[i] = (float) src[i]
+    void toFloat(float* dest, const double* src, int numSamples) noexcept;
+
+    // Lets sample-type templates get a float view of a channel: float input is
+    // returned as is, double input is converted into scratch.
+    inline const float* asFloat(const float* src, float* /*scratch*/, int /*numSamples*/) noexcept
+    {
+        return src;
+    }
+
+    inline const float* asFloat(const double* src, float* scratch, int numSamples) noexcept
+    {
+        toFloat(scratch, src, numSamples);
+        return scratch;
+    }
+}
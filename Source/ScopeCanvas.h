@@ -0,0 +1,65 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Where ScopeRenderer's geometry ends up. The renderer decides what to draw
+// (points, colours, widths); a canvas decides how pixels get made, so the
+// software and OpenGL backends share every line of scope logic.
+//
+// Render thread: each frame is beginFrame(), any number of clip changes and
+// draws, then endFrame().
+class ScopeCanvas
+{
+public:
+    virtual ~ScopeCanvas() = default;
+
+    // Canvases accumulate linear light and tone-map it as 1 - 1 / (1 + v + v^2/2)
+    // with v = light * exposure: a single opaque stroke lands at about 80% brightness
+    static constexpr float exposure = 2.0f;
+
+    // Starts a frame and fades what is already there towards black
+    virtual void beginFrame(int width, int height, float fadeAlpha) = 0;
+
+    // Following draws are limited to area (a tile, or the whole frame)
+    virtual void setClip(juce::Rectangle<float> area) = 0;
+
+    // A straight stroke with butt ends
+    virtual void drawSegment(juce::Point<float> start, juce::Point<float> end, float thickness, juce::Colour colour) = 0;
+
+    // A filled circle
+    virtual void drawDot(juce::Point<float> centre, float diameter, juce::Colour colour) = 0;
+
+    // Whether dots are cheap enough for particle mode to draw one per
+    // sample; otherwise it draws every 4th
+    virtual bool hasCheapDots() const noexcept { return false; }
+
+    // Phosphor mode: a one pixel beam through numPoints points in order. Each
+    // step between two points deposits the same light (the colour of its
+    // first point) spread along its length, so where the beam moves slowly
+    // it lights the screen more, like on an analog scope. Canvases without
+    // a dedicated beam draw thin strokes dimmed by their length.
+    virtual void drawBeam(const float* x, const float* y, const juce::Colour* colours, int numPoints)
+    {
+        for (int i = 0; i + 1 < numPoints; ++i)
+        {
+            const juce::Point<float> start(x[i], y[i]), end(x[i + 1], y[i + 1]);
+            const float length = start.getDistanceFrom(end);
+            drawSegment(start, end, 1.0f, colours[i].withMultipliedAlpha(juce::jmin(1.0f, 1.0f / juce::jmax(1.0f, length))));
+        }
+    }
+
+    // How strongly accumulated light is compressed before tone-mapping:
+    // 0 leaves it linear, 1 is close to logarithmic, so the faint single
+    // passes of a dense phosphor picture stay visible next to bright spots
+    virtual void setDensityCurve(float /*amount*/) {}
+
+    // Screen-space glow for the current frame: everything drawn is blurred
+    // (Gaussian, radius in pixels) and added on top with the given strength
+    // when presenting, without feeding back into persistence. Canvases that
+    // can't do this return false, and the renderer draws glow as geometry.
+    virtual bool supportsBloom() const noexcept { return false; }
+    virtual void setBloom(float /*strength*/, float /*radius*/) {}
+
+    virtual void endFrame() = 0;
+};
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    Precomputed hue table for trace colours.
+
+  ==============================================================================
+*/
+
+#include "ScopePalette.h"
+
+//==============================================================================
+ScopePalette::ScopePalette()
+{
+    setColours(0.0f, false);
+}
+
+void ScopePalette::setColours(float hueShift, bool invert)
+{
+    shift = hueShift;
+    inverted = invert;
+
+    for (int i = 0; i < numHues; ++i)
+    {
+        // Same order as the per-segment code had: shift first, then mirror
+        float hue = (float)i / (float)numHues + shift;
+        hue -= std::floor(hue);
+
+        if (inverted)
+            hue = 1.0f - hue;
+
+        const auto colour = juce::Colour::fromHSV(hue, 1.0f, 1.0f, 1.0f);
+        red[(size_t)i] = colour.getFloatRed();
+        green[(size_t)i] = colour.getFloatGreen();
+        blue[(size_t)i] = colour.getFloatBlue();
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Trace colours without per-segment HSV conversion.
+//
+// Hues are fixed-point turns (2^32 = one full turn), so offsets and sweeps
+// wrap for free where the float version needed fmod. The table holds the
+// fully saturated colour of each quantised hue with the hue shift and
+// inversion already applied, and is only rebuilt when those change;
+// saturation and value are then one multiply-add per channel, which is
+// exactly what HSV does for them.
+class ScopePalette
+{
+public:
+    using Hue = juce::uint32;
+
+    ScopePalette();
+
+    // Render thread. Rebuilds the table; the renderer calls this when the
+    // hue shift or inversion parameter changed.
+    void setColours(float hueShift, bool invert);
+
+    // Turns a hue before shift and inversion (any range, wraps) into a Hue
+    static Hue toHue(float hue) noexcept
+    {
+        return (Hue)(juce::int64)std::floor((double)hue * 4294967296.0);
+    }
+
+    // A sweep of amount turns in the direction it appears on screen: when
+    // inverted, table hues run backwards, so the raw sweep does too
+    juce::int32 getSweepStep(float amount, int numSteps) const noexcept
+    {
+        const auto step = (juce::int32)(amount * 4294967296.0 / juce::jmax(1, numSteps));
+        return inverted ? -step : step;
+    }
+
+    juce::Colour getColour(Hue hue, float saturation, float value, float alpha) const noexcept
+    {
+        const auto index = (size_t)(hue >> (32 - hueBits));
+        const float grey = value * (1.0f - saturation);
+        const float tint = value * saturation;
+
+        return juce::Colour::fromFloatRGBA(grey + tint * red[index],
+                                           grey + tint * green[index],
+                                           grey + tint * blue[index],
+                                           alpha);
+    }
+
+private:
+    static constexpr int hueBits = 10;
+    static constexpr int numHues = 1 << hueBits;
+
+    std::array<float, numHues> red, green, blue;
+    float shift = 0.0f;
+    bool inverted = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopePalette)
+};
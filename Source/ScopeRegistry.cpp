@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    Process-wide list of scope streams.
+
+  ==============================================================================
+*/
+
+#include "ScopeRegistry.h"
+
+//==============================================================================
+bool ScopeRegistry::add(ScopeStream* stream)
+{
+    jassert(stream != nullptr);
+
+    const juce::ScopedLock sl(lock);
+
+    if (streams.size() >= maxStreams)
+        return false;
+
+    streams.addIfNotAlreadyThere(stream);
+    return true;
+}
+
+void ScopeRegistry::remove(ScopeStream* stream)
+{
+    // Released outside the lock, in case this is the last reference
+    ScopeStream::Ptr removed;
+
+    const juce::ScopedLock sl(lock);
+    const int index = streams.indexOf(stream);
+
+    if (index >= 0)
+        removed = streams.removeAndReturn(index);
+}
+
+//==============================================================================
+juce::Array<ScopeStream::Ptr> ScopeRegistry::getStreams() const
+{
+    const juce::ScopedLock sl(lock);
+    return streams;
+}
+
+ScopeStream::Ptr ScopeRegistry::findStream(int streamId) const
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto& stream : streams)
+        if (stream->getId() == streamId)
+            return stream;
+
+    return nullptr;
+}
+
+float ScopeRegistry::getHueForStream(int streamId) noexcept
+{
+    constexpr double goldenRatioConjugate = 0.6180339887498949;
+    const double h = (double)streamId * goldenRatioConjugate;
+    return (float)(h - std::floor(h));
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScopeStream.h"
+
+//==============================================================================
+// Process-wide list of every instance's scope stream (hold it through
+// juce::SharedResourcePointer), so one editor can overlay several tracks.
+//
+// Any thread: hosts may create and delete instances off the message thread
+// (plugin scanners, offline renders). A lock guards the list, and readers get
+// their own references, so a stream withdrawn meanwhile stays alive for as
+// long as they hold it. The audio thread never touches the registry at all.
+class ScopeRegistry
+{
+public:
+    ScopeRegistry() = default;
+
+    static constexpr int maxStreams = 64;
+
+    // Returns false if the registry is full.
+    bool add(ScopeStream* stream);
+    void remove(ScopeStream* stream);
+
+    juce::Array<ScopeStream::Ptr> getStreams() const;
+    ScopeStream::Ptr findStream(int streamId) const;
+
+    // Stable per-source hue offset for overlays, spread by the golden ratio
+    // so neighbouring ids never land on similar colours.
+    static float getHueForStream(int streamId) noexcept;
+
+private:
+    juce::CriticalSection lock;
+    juce::Array<ScopeStream::Ptr> streams;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeRegistry)
+};
@@ -0,0 +1,738 @@
+/*
+  ==============================================================================
+
+    Scope frame rendering, independent of the editor component so it can run
+    on the render scheduler's worker threads.
+
+  ==============================================================================
+*/
+
+#include "ScopeRenderer.h"
+#include "PluginProcessor.h"
+
+//==============================================================================
+ScopeRenderer::ScopeRenderer(XYscopeAudioProcessor& p)
+    : processor(p)
+{
+    // Layer 0: our own processor, in the user's colours
+    layers.add(new Layer());
+
+    setPointBudget(processor.getPointBudget());
+}
+
+ScopeRenderer::~ScopeRenderer()
+{
+    setOverlaySources({});
+}
+
+void ScopeRenderer::setCanvas(ScopeCanvas* canvasToUse)
+{
+    canvas = canvasToUse != nullptr ? canvasToUse : &software;
+}
+
+//==============================================================================
+void ScopeRenderer::setOverlaySources(const juce::Array<ScopeStream::Ptr>& streams)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    // Drop layers that are no longer wanted (layer 0 is always our own processor)
+    for (int i = layers.size(); --i >= 1;)
+    {
+        auto* layer = layers.getUnchecked(i);
+
+        if (! streams.contains(layer->stream))
+        {
+            layer->stream->detachViewer();
+            layers.remove(i);
+        }
+    }
+
+    for (auto& stream : streams)
+    {
+        if (stream == nullptr || stream == processor.getScopeStream())
+            continue;
+
+        bool alreadyShown = false;
+
+        for (auto* layer : layers)
+            alreadyShown = alreadyShown || layer->stream == stream;
+
+        if (alreadyShown)
+            continue;
+
+        stream->attachViewer();
+
+        auto* layer = layers.add(new Layer());
+        layer->stream = stream;
+        layer->cursor = stream->getRing()->getWritePosition();
+        layer->hueOffset = ScopeRegistry::getHueForStream(stream->getId());
+    }
+}
+
+juce::Array<ScopeStream::Ptr> ScopeRenderer::getOverlaySources() const
+{
+    juce::Array<ScopeStream::Ptr> result;
+
+    for (int i = 1; i < layers.size(); ++i)
+        result.add(layers.getUnchecked(i)->stream);
+
+    return result;
+}
+
+//==============================================================================
+juce::Rectangle<float> ScopeRenderer::getTileBounds(juce::Rectangle<float> area, int numTiles, int index)
+{
+    if (numTiles <= 1)
+        return area;
+
+    // As square a grid as the tile count allows, filled row by row
+    const int columns = (int)std::ceil(std::sqrt((double)numTiles));
+    const int rows = (numTiles + columns - 1) / columns;
+
+    const float tileWidth = area.getWidth() / (float)columns;
+    const float tileHeight = area.getHeight() / (float)rows;
+
+    return { area.getX() + (float)(index % columns) * tileWidth,
+             area.getY() + (float)(index / columns) * tileHeight,
+             tileWidth, tileHeight };
+}
+
+juce::uint32 ScopeRenderer::getPairMask(const Layer& layer) const noexcept
+{
+    return layer.stream == nullptr ? processor.getEnabledPairMask() : layer.stream->getPairMask();
+}
+
+//==============================================================================
+void ScopeRenderer::renderFrame(int width, int height)
+{
+    // Decaying trails would otherwise spend ages in denormal range
+    juce::ScopedNoDenormals noDenormals;
+
+    profiler.beginFrame();
+
+    // Tables that depend on parameters are only rebuilt when those change
+    const auto changes = readSettings();
+
+    // Phosphor brightness is where the beam dwells, which only every sample
+    // shows: resampling would keep a run's extremes and lose its density
+    const int N = maxFramePoints;
+    const int budget = settings.renderMode == XYscopeAudioProcessor::phosphorRender ? 0 : pointBudget.load();
+
+    // With a budget, everything since the last frame is worth pulling: it
+    // gets resampled to the budget, so drawing costs the same either way
+    const int maxPull = budget > 0 ? maxPulledSamples : N;
+    bool anyNewSamples = false;
+    bool anySignal = false;
+
+    for (auto* layer : layers)
+    {
+        const FrameProfiler::ScopedStage timer(profiler, FrameProfiler::pull);
+
+        if (layer->scratch.size() != (size_t)XYscopeAudioProcessor::numScopeChannels)
+        {
+            layer->scratch.resize((size_t)XYscopeAudioProcessor::numScopeChannels);
+            layer->points.resize((size_t)XYscopeAudioProcessor::numScopeChannels);
+            layer->traces.resize((size_t)XYscopeAudioProcessor::maxChannelPairs);
+            layer->resampler = std::make_unique<ScopeResampler>(XYscopeAudioProcessor::numScopeChannels);
+        }
+
+        for (auto& channel : layer->scratch)
+            if ((int)channel.size() < maxPull)
+                channel.resize((size_t)maxPull);
+
+        // Checked before pulling, so signal written meanwhile counts next frame
+        const auto signal = getLayerStream(*layer)->getSignalCount();
+        anySignal = anySignal || signal != layer->signalSeen;
+        layer->signalSeen = signal;
+
+        layer->numSamples = pullLayer(*layer, maxPull);
+        layer->resampled = budget > 0 && layer->numSamples >= 2;
+
+        if (layer->resampled)
+            layer->numSamples = resampleLayer(*layer, budget);
+
+        anyNewSamples = anyNewSamples || layer->numSamples >= 2;
+    }
+
+    // Without new samples the frame still goes ahead: what's on screen keeps
+    // fading until the editor sees the renderer idle and stops asking
+
+    if ((changes & coloursChanged) != 0)
+        palette.setColours(settings.hueShift, settings.invertColours);
+
+    if ((changes & patternChanged) != 0)
+        unitShapes.setPattern(settings.monoShape, settings.waveType, settings.monoWraps);
+
+    if ((int)segmentHues.size() != N)
+    {
+        segmentHues.resize(N);
+        segmentColours.resize(N);
+        sideOffsets.resize(N);
+        pointX.resize(N);
+        pointY.resize(N);
+    }
+
+    // Resolution is only worth trading on the software canvas, whose cost
+    // goes with the pixel count; other canvases rasterize at window size
+    governor.setOptions(canvas == &software, settings.glowIntensity > 0.0f && ! canvas->supportsBloom());
+    quality = governor.getQuality();
+
+    const int renderWidth = juce::jmax(1, juce::roundToInt((float)width * quality.renderScale));
+    const int renderHeight = juce::jmax(1, juce::roundToInt((float)height * quality.renderScale));
+
+    // Decay by measured time since the last frame, so trails keep their
+    // length whatever rate frames actually arrive at; offline, by the fixed
+    // interval between frames
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    double frameMs = lastFrameMs > 0.0 ? juce::jlimit(0.0, maxFrameGapMs, now - lastFrameMs)
+                                       : XYscopeAudioProcessor::tracerReferenceFrameMs;
+    lastFrameMs = now;
+
+    if (fixedFrameMs > 0.0)
+        frameMs = fixedFrameMs;
+
+    const double halfLifeMs = XYscopeAudioProcessor::getTracerHalfLifeMs(settings.persist);
+    const float retained = halfLifeMs > 0.0 ? (float)std::exp2(-frameMs / halfLifeMs) : 0.0f;
+
+    // The frame that completes the fade-out clears what's left outright, so
+    // going idle never freezes a residue on screen, whatever the canvas keeps
+    const bool fadesOut = ! anySignal && quietMs + frameMs >= settleHalfLives * halfLifeMs;
+    const float fadeAlpha = fadesOut ? 1.0f : juce::jlimit(0.0f, 1.0f, 1.0f - retained);
+
+    // One fade for the whole frame, then every source draws into the same image
+    software.setPresentScale(quality.renderScale);
+
+    {
+        const FrameProfiler::ScopedStage timer(profiler, FrameProfiler::fade);
+        canvas->beginFrame(renderWidth, renderHeight, fadeAlpha);
+    }
+
+    // Glow as a screen-space bloom where the canvas has one. Sized to match
+    // the stroked glow it replaces: a Gaussian about as wide as the glow
+    // strokes were, carrying about as much light at its peak.
+    if (canvas->supportsBloom())
+        canvas->setBloom(0.4f * settings.glowSize * settings.glowIntensity,
+                         0.6f * settings.glowSize * settings.thickness * quality.renderScale);
+
+    // Phosphor traces pile up far more light than strokes; compress it
+    if (settings.renderMode == XYscopeAudioProcessor::phosphorRender)
+        canvas->setDensityCurve(settings.phosphorCurve);
+
+    // Tiled view: one tile per channel pair that any source is showing
+    const bool tiled = settings.pairView == XYscopeAudioProcessor::tiledPairs;
+    juce::uint32 pairsShown = 0;
+
+    for (auto* layer : layers)
+        if (layer->numSamples >= 2)
+            pairsShown |= getPairMask(*layer);
+
+    if (anyNewSamples)
+        shownPairs.store(pairsShown);
+
+    const int numTiles = tiled ? juce::countNumberOfBits(pairsShown) : 1;
+    const auto bounds = juce::Rectangle<int>(renderWidth, renderHeight).toFloat();
+
+    for (auto* layer : layers)
+    {
+        if (layer->numSamples < 2)
+            continue;
+
+        const auto mask = getPairMask(*layer);
+        const auto& samples = layer->resampled ? layer->points : layer->scratch;
+
+        // Band envelopes exist once per source, for the downmix of its first pair
+        const float* bands[] = { samples[XYscopeAudioProcessor::bassChannel].data(),
+                                 samples[XYscopeAudioProcessor::midChannel].data(),
+                                 samples[XYscopeAudioProcessor::highChannel].data() };
+
+        for (int pair = 0; pair < XYscopeAudioProcessor::maxChannelPairs; ++pair)
+        {
+            if ((mask & (1u << pair)) == 0)
+                continue;
+
+            const int channel = XYscopeAudioProcessor::getPairChannel(pair);
+            const float* left = samples[(size_t)channel].data();
+            const float* right = samples[(size_t)channel + 1].data();
+            auto& trace = layer->traces[(size_t)pair];
+            profiler.addSamples(layer->numSamples);
+
+            if (tiled)
+            {
+                const int tile = juce::countNumberOfBits(pairsShown & ((1u << pair) - 1));
+                const auto area = getTileBounds(bounds, numTiles, tile);
+
+                canvas->setClip(area);
+                drawTrace(*canvas, trace, left, right, bands, layer->numSamples, layer->hueOffset, area);
+            }
+            else
+            {
+                // Overlaid pairs of one source are told apart by hue
+                const float pairHue = std::fmod((float)pair * 0.618034f, 1.0f);
+                drawTrace(*canvas, trace, left, right, bands, layer->numSamples, layer->hueOffset + pairHue, bounds);
+            }
+        }
+    }
+
+    {
+        const FrameProfiler::ScopedStage timer(profiler, FrameProfiler::finish);
+        canvas->endFrame();
+    }
+
+    // Pulling and stroking go with the samples drawn; fading, bloom and
+    // tone-mapping with the pixels
+    const auto& record = profiler.endFrame(renderWidth, renderHeight, quality.renderScale);
+    const double pixelMs = record.stageMs[FrameProfiler::fade] + record.stageMs[FrameProfiler::finish];
+    governor.addFrame(record.totalMs - pixelMs, pixelMs);
+
+    // Idle once the last signal has had time to fade out completely; with an
+    // endless tracer, once the picture has had a while to settle
+    quietMs = anySignal ? 0.0 : quietMs + frameMs;
+    idle.store(quietMs >= juce::jmin(settleHalfLives * halfLifeMs, maxSettleMs));
+
+    // Idle, the editor stops pulling: the ring filling up meanwhile is no overrun
+    if (idle.load())
+        processor.pauseFifoStats();
+}
+
+bool ScopeRenderer::hasNewSignal() const
+{
+    for (auto* layer : layers)
+        if (getLayerStream(*layer)->getSignalCount() != layer->signalSeen)
+            return true;
+
+    return false;
+}
+
+ScopeStream* ScopeRenderer::getLayerStream(const Layer& layer) const noexcept
+{
+    // Our own processor keeps its stream alive for as long as we exist
+    return layer.stream != nullptr ? layer.stream.get() : processor.getScopeStream().get();
+}
+
+juce::uint32 ScopeRenderer::readSettings()
+{
+    auto load = [](const std::atomic<float>* param, float fallback) { return param != nullptr ? param->load() : fallback; };
+
+    Settings next;
+    next.persist = load(processor.persistParam, 0.85f);
+    next.saturation = load(processor.saturationParam, 1.0f);
+    next.hueShift = load(processor.hueShiftParam, 0.0f);
+    next.monoAmount = load(processor.monoAmountParam, 0.0f);
+    next.monoWraps = load(processor.monoWrapsParam, 3.0f);
+    next.dcOffset = load(processor.dcOffsetParam, 0.0f);
+    next.thickness = load(processor.thicknessParam, 1.0f);
+    next.glowIntensity = load(processor.glowIntensityParam, 1.0f);
+    next.glowSize = load(processor.glowSizeParam, 5.0f);
+    next.zoom = load(processor.zoomParam, 1.0f);
+    next.gainDb = load(processor.gainDbParam, 0.0f);
+    next.rotateDeg = load(processor.rotateDegParam, 0.0f);
+    next.monoShape = (int)load(processor.monoShapeParam, 0.0f);
+    next.waveType = (int)load(processor.waveTypeParam, 0.0f);
+    next.colourMode = processor.getColourMode();
+    next.pairView = processor.getPairView();
+    next.renderMode = processor.getRenderMode();
+    next.phosphorCurve = load(processor.phosphorCurveParam, 0.5f);
+    next.invertColours = load(processor.invertColorsParam, 0.0f) > 0.5f;
+
+    juce::uint32 changes = 0;
+
+    if (! hasSettings || next.hueShift != settings.hueShift || next.invertColours != settings.invertColours)
+        changes |= coloursChanged;
+
+    if (! hasSettings || next.monoShape != settings.monoShape || next.waveType != settings.waveType
+        || next.monoWraps != settings.monoWraps)
+        changes |= patternChanged;
+
+    settings = next;
+    hasSettings = true;
+    return changes;
+}
+
+int ScopeRenderer::pullLayer(Layer& layer, int maxSamples)
+{
+    float* dest[XYscopeAudioProcessor::numScopeChannels] = {};
+
+    for (int c = 0; c < XYscopeAudioProcessor::numScopeChannels; ++c)
+        dest[c] = layer.scratch[(size_t)c].data();
+
+    if (layer.stream == nullptr)
+        return processor.pullSamples(dest, maxSamples);
+
+    // Another instance: read with our own cursor so its editor's reads are
+    // untouched, and skip the pairs it isn't publishing
+    const auto mask = layer.stream->getPairMask();
+
+    for (int pair = 1; pair < XYscopeAudioProcessor::maxChannelPairs; ++pair)
+    {
+        if ((mask & (1u << pair)) == 0)
+        {
+            const int channel = XYscopeAudioProcessor::getPairChannel(pair);
+            dest[channel] = dest[channel + 1] = nullptr;
+        }
+    }
+
+    auto* ring = layer.stream->getRing();
+    return ring != nullptr ? ring->read(layer.cursor, dest, maxSamples) : 0;
+}
+
+int ScopeRenderer::resampleLayer(Layer& layer, int budget)
+{
+    float* source[XYscopeAudioProcessor::numScopeChannels] = {};
+    float* dest[XYscopeAudioProcessor::numScopeChannels] = {};
+
+    for (int c = 0; c < XYscopeAudioProcessor::numScopeChannels; ++c)
+    {
+        auto& points = layer.points[(size_t)c];
+
+        if ((int)points.size() != maxFramePoints)
+            points.resize((size_t)maxFramePoints);
+
+        source[c] = layer.scratch[(size_t)c].data();
+        dest[c] = points.data();
+    }
+
+    // The first pair always, as the band envelopes follow its choice of samples
+    const int firstPair[] = { XYscopeAudioProcessor::leftChannel, XYscopeAudioProcessor::rightChannel,
+                              XYscopeAudioProcessor::bassChannel, XYscopeAudioProcessor::midChannel,
+                              XYscopeAudioProcessor::highChannel };
+
+    const int numPoints = layer.resampler->process(source, dest, firstPair, (int)std::size(firstPair),
+                                                   layer.numSamples, budget);
+
+    const auto mask = getPairMask(layer);
+
+    for (int pair = 1; pair < XYscopeAudioProcessor::maxChannelPairs; ++pair)
+    {
+        if ((mask & (1u << pair)) == 0)
+            continue;
+
+        const int channel = XYscopeAudioProcessor::getPairChannel(pair);
+        const int channels[] = { channel, channel + 1 };
+        layer.resampler->process(source, dest, channels, 2, layer.numSamples, budget);
+    }
+
+    return numPoints;
+}
+
+void ScopeRenderer::drawTrace(ScopeCanvas& target, Trace& trace, const float* scratchL, const float* scratchR,
+                              const float* const* bands, int got, float hueOffset, juce::Rectangle<float> area)
+{
+    const float* scratchBass = bands[0];
+    const float* scratchMid = bands[1];
+    const float* scratchHigh = bands[2];
+    float& visualGainSmoothed = trace.visualGainSmoothed;
+    float& colourEnergySmoothed = trace.colourEnergySmoothed;
+    float& dcPhase = trace.dcPhase;
+    double lapMs = juce::Time::getMillisecondCounterHiRes();
+
+    // --- Visual auto-gain (AGC) ---
+    float peak = 1.0e-6f; // avoid divide-by-zero
+    for (int i = 0; i < got; ++i)
+    {
+        // Use mid or max of L/R; choose what "fills" best for your aesthetic
+        float m = 0.5f * (std::fabs(scratchL[i]) + std::fabs(scratchR[i]));
+        if (m > peak) peak = m;
+    }
+
+    // --- Global energy for colour (frame-level) ---
+    float e = 0.0f;
+    for (int i = 0; i < got; ++i)
+    {
+        float m = 0.5f * (scratchL[i] + scratchR[i]); // mid
+        e += m * m;
+    }
+    e = std::sqrt(e / (float)got); // RMS ~ 0..1
+
+    // Smooth it so colours don't flicker
+    const float colourAttack = 0.25f;
+    const float colourRelease = 0.05f;
+    if (e > colourEnergySmoothed)
+        colourEnergySmoothed += (e - colourEnergySmoothed) * colourAttack;
+    else
+        colourEnergySmoothed += (e - colourEnergySmoothed) * colourRelease;
+
+    // Map RMS to a usable 0..1 control signal (tune these)
+    float energyNorm = juce::jmap(colourEnergySmoothed, 0.02f, 0.25f, 0.0f, 1.0f);
+    energyNorm = juce::jlimit(0.0f, 1.0f, energyNorm);
+
+
+    // We want peak * visualGain ? desiredPeak
+    // desiredPeak is in "audio units" before scale; tune by feel.
+    const float desiredPeak = 0.35f; // 0..1-ish
+    float targetVisualGain = desiredPeak / peak;
+
+    // Clamp so silence doesn't blow up and loud signals don't vanish
+    targetVisualGain = juce::jlimit(0.25f, 20.0f, targetVisualGain);
+
+    // Smooth: faster attack, slower release
+    const float attack = 0.25f;   // increase = faster response to quiet signals
+    const float release = 0.05f;  // decrease = slower drop when signal gets loud
+
+    if (targetVisualGain > visualGainSmoothed)
+        visualGainSmoothed += (targetVisualGain - visualGainSmoothed) * attack;
+    else
+        visualGainSmoothed += (targetVisualGain - visualGainSmoothed) * release;
+
+    const float zoom = settings.zoom;
+    const float gain = juce::Decibels::decibelsToGain(settings.gainDb);
+    const float a = juce::degreesToRadians(settings.rotateDeg);
+    const float c = std::cos(a);
+    const float s = std::sin(a);
+
+    const float cx = area.getCentreX();
+    const float cy = area.getCentreY();
+    const float scale = 0.45f * std::min(area.getWidth(), area.getHeight());
+
+    // The mono pattern only depends on where a sample sits in the frame
+    const float* unitX = nullptr;
+    const float* unitY = nullptr;
+    unitShapes.getUnitShape(got, unitX, unitY);
+
+    const float overallGain = gain * zoom * visualGainSmoothed;
+
+    // Draw in chunks with varying thickness and spread
+    const int chunkSize = 128;
+    profiler.addLap(FrameProfiler::analysis, lapMs);
+
+    for (int chunkStart = 0; chunkStart < got; chunkStart += chunkSize)
+    {
+        int chunkEnd = std::min(chunkStart + chunkSize, got);
+        int chunkLen = chunkEnd - chunkStart;
+
+        if (chunkLen < 2)
+            continue;
+
+        // User controls, as of the start of this frame
+        const float satControl = settings.saturation;
+        const float monoAmount = settings.monoAmount;
+        const float thicknessControl = settings.thickness;
+        const float glowIntensity = settings.glowIntensity;
+        const float glowSize = settings.glowSize;
+        const bool strokedGlow = glowIntensity > 0.0f && ! target.supportsBloom();
+        const int glowPasses = quality.glowPasses;
+        const int pointStride = quality.pointStride;
+        const int renderMode = settings.renderMode;
+        const int colourMode = settings.colourMode;
+        const float dcOffset = settings.dcOffset;
+
+        // Calculate stereo width for this chunk
+        float widthSum = 0.0f;
+        for (int i = chunkStart; i < chunkEnd; ++i)
+        {
+            float diff = std::abs(scratchL[i] - scratchR[i]);
+            widthSum += diff;
+        }
+
+        float stereoWidth = widthSum / (float)chunkLen;
+        stereoWidth = juce::jlimit(0.0f, 1.0f, stereoWidth * 0.5f);
+        stereoWidth *= (1.0f - monoAmount);
+
+        // Chunk energy (RMS-ish)
+        float e = 0.0f;
+        for (int i = chunkStart; i < chunkEnd; ++i)
+        {
+            float m = 0.5f * (scratchL[i] + scratchR[i]);
+            e += m * m;
+        }
+        e = std::sqrt(e / (float)chunkLen); // RMS 0..~1
+
+        // Map energy to hue: clamp to a reasonable range
+        float energyNorm = juce::jlimit(0.0f, 1.0f, e * 3.0f); // tune multiplier
+        float hue = juce::jmap(energyNorm, 0.0f, 1.0f, 0.60f, 0.00f); // blue->red
+        float sat = juce::jmap(stereoWidth, 0.0f, 1.0f, 0.25f, 1.0f); // mono less saturated, stereo more
+        float val = 1.0f;
+
+        // Hue calculation - either energy-based or frequency-based
+        if (colourMode == XYscopeAudioProcessor::fftColour)
+        {
+            // FFT MODE: Color based on frequency content
+            const auto bands = processor.getBandEnergies();
+            float bass = bands.bass;
+            float mid = bands.mid;
+            float high = bands.high;
+
+            // Map frequencies to hue ranges
+            // Bass = red/orange (0.0-0.1), Mids = green/yellow (0.3-0.4), Highs = blue/cyan (0.5-0.65)
+            float dominantFreq = std::max({ bass, mid, high });
+
+            if (bass == dominantFreq)
+                hue = juce::jmap(bass, 0.0f, 1.0f, 0.0f, 0.1f); // Red-orange for bass
+            else if (mid == dominantFreq)
+                hue = juce::jmap(mid, 0.0f, 1.0f, 0.25f, 0.4f); // Green-yellow for mids
+            else
+                hue = juce::jmap(high, 0.0f, 1.0f, 0.5f, 0.65f); // Cyan-blue for highs
+        }
+        else
+        {
+            // ENERGY MODE: Color based on overall energy (original behavior)
+            hue = juce::jmap(energyNorm, 0.0f, 1.0f, 0.75f, 0.05f);
+        }
+
+        // Hue shift and inversion live in the palette table
+        const auto chunkHue = ScopePalette::toHue(hue + hueOffset);
+
+        // Saturation: controlled by user, modulated by stereo width
+        float baseSat = juce::jmap(stereoWidth, 0.0f, 1.0f, 0.55f, 1.00f);
+        sat = baseSat * satControl;
+        sat = juce::jlimit(0.0f, 1.0f, sat);
+
+        // Value (brightness): loud = brighter
+        val = juce::jmap(energyNorm, 0.0f, 1.0f, 0.75f, 1.00f);
+
+        // Per-segment hue: a sweep across the chunk, or in crossover mode the
+        // hue of the dominant band at that very sample
+        if (colourMode == XYscopeAudioProcessor::crossoverColour)
+        {
+            for (int i = chunkStart; i < chunkEnd; ++i)
+            {
+                const float bass = juce::jlimit(0.0f, 1.0f, scratchBass[i]);
+                const float mid = juce::jlimit(0.0f, 1.0f, scratchMid[i]);
+                const float high = juce::jlimit(0.0f, 1.0f, scratchHigh[i]);
+
+                float bandHue;
+                if (bass >= mid && bass >= high)
+                    bandHue = juce::jmap(bass, 0.0f, 1.0f, 0.0f, 0.1f);
+                else if (mid >= high)
+                    bandHue = juce::jmap(mid, 0.0f, 1.0f, 0.25f, 0.4f);
+                else
+                    bandHue = juce::jmap(high, 0.0f, 1.0f, 0.5f, 0.65f);
+
+                segmentHues[i] = ScopePalette::toHue(bandHue + hueOffset);
+            }
+        }
+        else
+        {
+            // 0.3 turns across the chunk; integer hues wrap on their own, so
+            // this is a plain ramp the compiler vectorises
+            const auto step = (ScopePalette::Hue)palette.getSweepStep(0.3f, chunkLen);
+            auto* sweep = segmentHues.data() + chunkStart;
+
+            for (int i = 0; i < chunkLen; ++i)
+                sweep[i] = chunkHue + (ScopePalette::Hue)i * step;
+        }
+
+
+        // Map to thickness: mono=thick, stereo=thin
+        float thickness = juce::jmap(stereoWidth, 0.0f, 1.0f, 3.5f, 1.0f);
+        thickness *= thicknessControl;  // Apply user control
+        thickness *= quality.renderScale; // Same size on screen at any render resolution
+
+        // Calculate spread multiplier: mono gets high multiplier, stereo gets 1.0
+        float spreadMult = juce::jmap(stereoWidth, 0.0f, 1.0f, 20.0f, 1.0f);
+
+        // Calculate waveform contribution: high for mono, zero for stereo
+        float waveformAmount = juce::jmap(stereoWidth, 0.0f, 0.2f, 0.8f, 0.0f);
+        waveformAmount = juce::jlimit(0.0f, 1.0f, waveformAmount);
+
+        
+        profiler.addLap(FrameProfiler::analysis, lapMs);
+
+        // Transform points for this chunk with dynamic spread: the plain XY
+        // picture blended with the mono pattern, then rotated into place
+        ScopeTransform::computeSideOffsets(sideOffsets.data() + chunkStart, chunkLen, dcOffset, dcPhase);
+
+        ScopeTransform::Mapping mapping;
+        mapping.sideGain = (1.0f - monoAmount) * spreadMult;
+        mapping.stereoGain = overallGain * (1.0f - waveformAmount);
+        mapping.patternGain = 0.4f * overallGain * waveformAmount;
+        mapping.cosAngle = c;
+        mapping.sinAngle = s;
+        mapping.centreX = cx;
+        mapping.centreY = cy;
+        mapping.scale = scale;
+
+        ScopeTransform::mapPoints(mapping, scratchL + chunkStart, scratchR + chunkStart, sideOffsets.data() + chunkStart,
+                                  unitX + chunkStart, unitY + chunkStart,
+                                  pointX.data() + chunkStart, pointY.data() + chunkStart, chunkLen);
+
+        profiler.addLap(FrameProfiler::transform, lapMs);
+
+        if (renderMode == XYscopeAudioProcessor::phosphorRender)
+        {
+            // PHOSPHOR RENDERING MODE
+            // Every sample, one beam through the chunk; light per step is
+            // fixed, so brightness shows where the trace dwells
+            for (int i = chunkStart; i < chunkEnd; ++i)
+                segmentColours[(size_t)i] = palette.getColour(segmentHues[i], sat, val, 1.0f);
+
+            target.drawBeam(pointX.data() + chunkStart, pointY.data() + chunkStart,
+                            segmentColours.data() + chunkStart, chunkLen);
+
+            profiler.addLap(FrameProfiler::core, lapMs);
+        }
+        else if (renderMode == XYscopeAudioProcessor::particleRender)
+        {
+            // PARTICLE RENDERING MODE
+            // Particle size based on amplitude
+            const float particleSize = thickness * 2.0f;
+
+            // A dot per sample where dots are cheap, each carrying a quarter of
+            // the light, so the trail looks the same only smoother
+            const int particleSpacing = target.hasCheapDots() ? 1 : 4;
+            const int particleStep = particleSpacing * pointStride;
+            const float particleAlpha = (float)particleSpacing / 4.0f;
+
+            // Glow for the chunk's particles first, like line mode (unless the canvas blooms)
+            for (int i = chunkStart; strokedGlow && i < chunkEnd; i += particleStep)
+            {
+                const auto segmentHue = segmentHues[i];
+
+                for (int glowPass = 0; glowPass < glowPasses; ++glowPass)
+                {
+                    float glowMult = glowSize - (glowPass * glowSize * 0.3f);
+                    float glowAlpha = (0.15f / (glowPass + 1)) * glowIntensity;
+
+                    // Glow stays saturated (progressively less saturated each layer for smooth gradient)
+                    float glowSat = juce::jmap((float)glowPass, 0.0f, 2.0f, 1.0f, 0.7f); // Outer layers slightly less saturated
+                    target.drawDot(getPoint(i), particleSize * glowMult,
+                                   palette.getColour(segmentHue, glowSat, val, glowAlpha));
+                }
+            }
+
+            profiler.addLap(FrameProfiler::glow, lapMs);
+
+            // Core particles on top
+            for (int i = chunkStart; i < chunkEnd; i += particleStep)
+                target.drawDot(getPoint(i), particleSize, palette.getColour(segmentHues[i], sat, val, particleAlpha));
+
+            profiler.addLap(FrameProfiler::core, lapMs);
+        }
+        else
+        {
+            // LINE RENDERING MODE
+// Multi-layer glow (unless the canvas blooms)
+            for (int glowPass = 0; strokedGlow && glowPass < glowPasses; ++glowPass)
+            {
+                float glowMult = glowSize - (glowPass * glowSize * 0.3f);
+                float glowAlpha = (0.15f / (glowPass + 1)) * glowIntensity;
+
+                for (int i = chunkStart; i < chunkEnd - 1; i += pointStride)
+                {
+                    const auto segmentHue = segmentHues[i];
+                    const int next = juce::jmin(i + pointStride, chunkEnd - 1);
+
+                    // Glow stays saturated (progressively less saturated each layer)
+                    float glowSat = juce::jmap((float)glowPass, 0.0f, 2.0f, 1.0f, 0.7f);
+
+                    // This is the key - thick glow lines
+                    target.drawSegment(getPoint(i), getPoint(next), thickness * glowMult,
+                                       palette.getColour(segmentHue, glowSat, val, glowAlpha));
+                }
+            }
+
+            profiler.addLap(FrameProfiler::glow, lapMs);
+
+            // Core pass: solid line on top (desaturates with saturation control)
+            for (int i = chunkStart; i < chunkEnd - 1; i += pointStride)
+            {
+                const auto segmentHue = segmentHues[i];
+                const int next = juce::jmin(i + pointStride, chunkEnd - 1);
+
+                // Core uses user saturation control (can go to white)
+                target.drawSegment(getPoint(i), getPoint(next), thickness, palette.getColour(segmentHue, sat, val, 1.0f));
+            }
+
+            profiler.addLap(FrameProfiler::core, lapMs);
+        }
+    }
+}
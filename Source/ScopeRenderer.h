@@ -0,0 +1,172 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScopeRegistry.h"
+#include "ScopePalette.h"
+#include "ScopeTransform.h"
+#include "QualityGovernor.h"
+#include "FrameProfiler.h"
+#include "ScopeResampler.h"
+#include "SoftwareScopeCanvas.h"
+
+class XYscopeAudioProcessor;
+
+//==============================================================================
+// Pulls new scope samples from the processor, plus any other instances the
+// user chose to overlay, and turns them into strokes and dots on a
+// ScopeCanvas: by default the software one, or e.g. an OpenGL canvas the
+// editor provides. Has no Component dependencies: renderFrame() runs on a
+// render scheduler worker, drawTo() on the message thread.
+class ScopeRenderer
+{
+public:
+    explicit ScopeRenderer(XYscopeAudioProcessor&);
+    ~ScopeRenderer();
+
+    // Render thread. Only one call may be in flight at a time.
+    void renderFrame(int width, int height);
+
+    // Message thread. Blits the most recently finished software frame.
+    void drawTo(juce::Graphics& g, juce::Rectangle<int> area) { software.drawTo(g, area); }
+
+    // Message thread, never while a frame is rendering. nullptr selects the
+    // built-in software canvas.
+    void setCanvas(ScopeCanvas* canvasToUse);
+    bool isUsingSoftwareCanvas() const noexcept { return canvas == &software; }
+
+    // Message thread, never while a frame is rendering. Attaches as a viewer to
+    // each listed stream and detaches from overlays no longer listed; our own
+    // processor's stream is always drawn and is ignored here.
+    void setOverlaySources(const juce::Array<ScopeStream::Ptr>& streams);
+    juce::Array<ScopeStream::Ptr> getOverlaySources() const;
+
+    // Message thread, never while a frame is rendering. Idle means no source
+    // has had signal (see ScopeStream::noteSignal) for long enough that the
+    // picture has faded out or settled: further frames would all look the
+    // same, so they can stop until hasNewSignal() or something else changes.
+    bool isIdle() const noexcept { return idle.load(); }
+    bool hasNewSignal() const;
+
+    // Any thread. Frame time the quality governor aims for; zero or less
+    // always renders at full quality.
+    void setFrameBudgetMs(double budgetMs) noexcept { governor.setBudgetMs(budgetMs); }
+
+    // Any thread. Points each source's new samples are resampled to per
+    // frame, at most maxFramePoints; zero draws the samples as they come.
+    // Phosphor mode always draws every sample, whatever the budget.
+    void setPointBudget(int numPoints) noexcept { pointBudget.store(juce::jlimit(0, maxFramePoints, numPoints)); }
+
+    // Most points drawn per source and channel pair in one frame
+    static constexpr int maxFramePoints = 4096;
+
+    // Render thread. Above zero, trails decay as if frames were exactly this
+    // far apart rather than by the clock, so offline renders are repeatable.
+    void setFixedFrameInterval(double intervalMs) noexcept { fixedFrameMs = intervalMs; }
+
+    // Stage timings of the frames rendered so far; the message thread adds
+    // the blit time after drawTo()
+    FrameProfiler& getProfiler() noexcept { return profiler; }
+
+    // Channel pairs drawn in the last frame (bit N = pair N), for tile labels
+    juce::uint32 getShownPairs() const noexcept { return shownPairs.load(); }
+
+    // Tiled pair view: where tile index of numTiles goes within area
+    static juce::Rectangle<float> getTileBounds(juce::Rectangle<float> area, int numTiles, int index);
+
+private:
+    // Smoothing state of one channel pair of one source
+    struct Trace
+    {
+        float visualGainSmoothed = 1.0f;
+        float colourEnergySmoothed = 0.0f;
+        float dcPhase = 0.0f;
+    };
+
+    // One source drawn into the frame
+    struct Layer
+    {
+        ScopeStream::Ptr stream; // null for our own processor
+        juce::uint64 cursor = 0;
+        float hueOffset = 0.0f;
+
+        std::vector<std::vector<float>> scratch; // one per scope ring channel
+        std::vector<std::vector<float>> points;  // scratch resampled to the point budget
+        std::unique_ptr<ScopeResampler> resampler;
+        std::vector<Trace> traces;               // one per channel pair
+        int numSamples = 0;                      // in points when resampled
+        bool resampled = false;
+        juce::uint32 signalSeen = 0;             // stream's signal count at the last pull
+    };
+
+    // Parameter values for one frame, read once before drawing so every
+    // trace and chunk of the frame sees the same values
+    struct Settings
+    {
+        float persist = 0.85f, saturation = 1.0f, hueShift = 0.0f;
+        float monoAmount = 0.0f, monoWraps = 3.0f, dcOffset = 0.0f;
+        float thickness = 1.0f, glowIntensity = 1.0f, glowSize = 5.0f;
+        float zoom = 1.0f, gainDb = 0.0f, rotateDeg = 0.0f;
+        float phosphorCurve = 0.5f;
+        int monoShape = 0, waveType = 0, colourMode = 0, renderMode = 0, pairView = 0;
+        bool invertColours = false;
+    };
+
+    // Dirty flags: what changed since the previous frame's settings
+    enum SettingsChange : juce::uint32
+    {
+        coloursChanged = 1u << 0, // hue shift or inversion: the palette
+        patternChanged = 1u << 1  // mono shape, wave or wraps: the unit shape
+    };
+
+    juce::uint32 readSettings();
+    int pullLayer(Layer&, int maxSamples);
+    int resampleLayer(Layer&, int budget);
+    ScopeStream* getLayerStream(const Layer&) const noexcept;
+    juce::uint32 getPairMask(const Layer&) const noexcept;
+    void drawTrace(ScopeCanvas&, Trace&, const float* left, const float* right,
+                   const float* const* bands, int numSamples, float hueOffset, juce::Rectangle<float> area);
+
+    XYscopeAudioProcessor& processor;
+    juce::OwnedArray<Layer> layers;
+    std::atomic<juce::uint32> shownPairs{ 0 };
+    double lastFrameMs = 0.0;
+    double fixedFrameMs = 0.0;
+
+    // Samples pulled per source at most in one frame when resampling: 85 ms
+    // at 192 kHz, so frames can be far apart before any are skipped
+    static constexpr int maxPulledSamples = 16384;
+    std::atomic<int> pointBudget{ 0 };
+
+    // Longer gaps (e.g. a stalled host) decay the trails as if this long
+    static constexpr double maxFrameGapMs = 1000.0;
+
+    // Quiet time before going idle: after 14 half-lives the trails are all
+    // but gone and the frame that gets there clears the rest; long and
+    // endless tracers instead freeze once they've had a few seconds to settle
+    static constexpr double settleHalfLives = 14.0;
+    static constexpr double maxSettleMs = 5000.0;
+    double quietMs = 0.0;
+    std::atomic<bool> idle{ false };
+
+    SoftwareScopeCanvas software;
+    ScopeCanvas* canvas = &software;
+
+    Settings settings;
+    bool hasSettings = false;
+
+    // Quality of the frame being drawn, as the governor last judged it
+    QualityGovernor governor;
+    QualityGovernor::Quality quality;
+    FrameProfiler profiler;
+
+    ScopePalette palette;
+    ScopeTransform::UnitShapeCache unitShapes;
+    std::vector<ScopePalette::Hue> segmentHues;
+    std::vector<juce::Colour> segmentColours; // phosphor beam, one per point
+
+    // Per-sample transform buffers, structure of arrays
+    std::vector<float> sideOffsets, pointX, pointY;
+    juce::Point<float> getPoint(int i) const noexcept { return { pointX[(size_t)i], pointY[(size_t)i] }; }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeRenderer)
+};
@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    Per-frame resampling of scope samples to a fixed point budget.
+
+  ==============================================================================
+*/
+
+#include "ScopeResampler.h"
+
+//==============================================================================
+ScopeResampler::ScopeResampler(int numChannels)
+    : history((size_t)numChannels)
+{
+    for (auto& h : history)
+        h.fill(0.0f);
+}
+
+const ScopeResampler::Kernel& ScopeResampler::getKernel()
+{
+    static const Kernel kernel = []
+    {
+        // Lanczos: sinc(x) * sinc(x / a) for |x| < a
+        const auto lanczos = [](double x)
+        {
+            if (std::abs(x) < 1.0e-9)
+                return 1.0;
+
+            if (std::abs(x) >= (double)radius)
+                return 0.0;
+
+            const double px = juce::MathConstants<double>::pi * x;
+            return (double)radius * std::sin(px) * std::sin(px / (double)radius) / (px * px);
+        };
+
+        Kernel k{};
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            const double fraction = (double)phase / (double)numPhases;
+            double sum = 0.0;
+
+            // Tap t is the sample t - (radius - 1) places after the point's
+            for (int t = 0; t < numTaps; ++t)
+                sum += lanczos(fraction - (double)(t - (radius - 1)));
+
+            // Normalised, so a constant signal comes out without ripple
+            for (int t = 0; t < numTaps; ++t)
+                k[(size_t)phase][(size_t)t] = (float)(lanczos(fraction - (double)(t - (radius - 1))) / sum);
+        }
+
+        return k;
+    }();
+
+    return kernel;
+}
+
+//==============================================================================
+int ScopeResampler::process(const float* const* source, float* const* dest, const int* channels, int numChannels,
+                            int numSamples, int numPoints)
+{
+    jassert(numChannels >= 2);
+
+    int numWritten = numSamples;
+
+    if (numSamples >= 2 && numPoints >= 2 && numSamples < numPoints)
+    {
+        upsample(source, dest, channels, numChannels, numSamples, numPoints);
+        numWritten = numPoints;
+    }
+    else if (numSamples >= 2 && numPoints >= 2 && numSamples > numPoints)
+    {
+        numWritten = decimate(source, dest, channels, numChannels, numSamples, numPoints);
+    }
+    else
+    {
+        for (int c = 0; c < numChannels; ++c)
+            std::copy(source[channels[c]], source[channels[c]] + numSamples, dest[channels[c]]);
+    }
+
+    keepHistory(source, channels, numChannels, numSamples);
+    return numWritten;
+}
+
+void ScopeResampler::upsample(const float* const* source, float* const* dest, const int* channels, int numChannels,
+                              int numSamples, int numPoints)
+{
+    const auto& kernel = getKernel();
+
+    tapStarts.resize((size_t)numPoints);
+    tapPhases.resize((size_t)numPoints);
+
+    // Point k sits at (k + 1) * numSamples / numPoints - 1 among the new
+    // samples: the last point on the last sample, the first just after the
+    // previous frame's last, so consecutive frames tile the signal evenly
+    for (int k = 0; k < numPoints; ++k)
+    {
+        const double position = (double)(k + 1) * (double)numSamples / (double)numPoints - 1.0;
+        const int index = (int)std::floor(position);
+
+        // Taps start radius - 1 samples before index, which sits radius into extended
+        tapStarts[(size_t)k] = index + 1;
+        tapPhases[(size_t)k] = juce::roundToInt((position - (double)index) * (double)numPhases);
+    }
+
+    extended.resize((size_t)(numSamples + numTaps));
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        const int channel = channels[c];
+        const float* in = source[channel];
+        float* out = dest[channel];
+
+        // The following frame isn't here yet: its samples are taken as the last one
+        const auto& h = history[(size_t)channel];
+        std::copy(h.begin(), h.end(), extended.begin());
+        std::copy(in, in + numSamples, extended.begin() + radius);
+        std::fill(extended.begin() + radius + numSamples, extended.end(), in[numSamples - 1]);
+
+        for (int k = 0; k < numPoints; ++k)
+        {
+            const float* x = extended.data() + tapStarts[(size_t)k];
+            const auto& w = kernel[(size_t)tapPhases[(size_t)k]];
+            float sum = 0.0f;
+
+            for (int t = 0; t < numTaps; ++t)
+                sum += w[(size_t)t] * x[t];
+
+            out[k] = sum;
+        }
+    }
+}
+
+int ScopeResampler::decimate(const float* const* source, float* const* dest, const int* channels, int numChannels,
+                             int numSamples, int numPoints)
+{
+    const int numRuns = numPoints / 2;
+    const float* x = source[channels[0]];
+    const float* y = source[channels[1]];
+
+    keep.resize((size_t)(2 * numRuns));
+
+    // At least two samples per run, as there are more samples than points
+    for (int run = 0; run < numRuns; ++run)
+    {
+        const int start = (int)((juce::int64)run * numSamples / numRuns);
+        const int end = (int)((juce::int64)(run + 1) * numSamples / numRuns);
+
+        int xMin = start, xMax = start, yMin = start, yMax = start;
+
+        for (int i = start + 1; i < end; ++i)
+        {
+            if (x[i] < x[xMin]) xMin = i;
+            if (x[i] > x[xMax]) xMax = i;
+            if (y[i] < y[yMin]) yMin = i;
+            if (y[i] > y[yMax]) yMax = i;
+        }
+
+        const bool alongX = x[xMax] - x[xMin] >= y[yMax] - y[yMin];
+        const int first = alongX ? xMin : yMin;
+        const int second = alongX ? xMax : yMax;
+
+        // In the order they were played
+        keep[(size_t)(2 * run)] = juce::jmin(first, second);
+        keep[(size_t)(2 * run + 1)] = juce::jmax(first, second);
+    }
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        const float* in = source[channels[c]];
+        float* out = dest[channels[c]];
+
+        for (size_t k = 0; k < keep.size(); ++k)
+            out[k] = in[keep[k]];
+    }
+
+    return (int)keep.size();
+}
+
+void ScopeResampler::keepHistory(const float* const* source, const int* channels, int numChannels, int numSamples)
+{
+    for (int c = 0; c < numChannels; ++c)
+    {
+        auto& h = history[(size_t)channels[c]];
+        const float* in = source[channels[c]];
+        std::array<float, radius> next;
+
+        // The last radius samples of the old history followed by the new ones
+        for (int t = 0; t < radius; ++t)
+        {
+            const int i = numSamples - radius + t;
+            next[(size_t)t] = i >= 0 ? in[i] : h[(size_t)(radius + i)];
+        }
+
+        h = next;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+// Brings each frame's new scope samples to a fixed number of points, so the
+// trace's density, the auto-gain and the cost of drawing stay the same
+// whatever the host's sample rate.
+//
+// Fewer samples than points are upsampled with a Lanczos kernel (a = 3),
+// which interpolates without adding content above the signal's band. The
+// last samples of each frame are kept so the kernel runs on across frame
+// boundaries rather than clamping at them.
+//
+// More samples than points are decimated in runs of samples, two points per
+// run: the samples where the trace reaches furthest each way along whichever
+// of X and Y moves more in that run. Peaks survive, and every point is a
+// real sample with its X and Y from the same instant, so the figure keeps
+// its shape rather than gaining corners that were never there.
+class ScopeResampler
+{
+public:
+    explicit ScopeResampler(int numChannels);
+
+    // Resamples numSamples new samples of the listed channels of source into
+    // dest, at the same channel indices. The first two listed channels are the
+    // X/Y pair that decides which samples decimation keeps; any others follow
+    // the same choice. Returns the number of points written, the same for any
+    // channel list: numPoints when upsampling, numPoints rounded down to even
+    // when decimating, numSamples when there is nothing to change.
+    int process(const float* const* source, float* const* dest, const int* channels, int numChannels,
+                int numSamples, int numPoints);
+
+private:
+    static constexpr int radius = 3;
+    static constexpr int numTaps = 2 * radius;
+    static constexpr int numPhases = 256;
+
+    // Kernel weights at numPhases + 1 fractional positions, each row summing to one
+    using Kernel = std::array<std::array<float, numTaps>, numPhases + 1>;
+    static const Kernel& getKernel();
+
+    void upsample(const float* const* source, float* const* dest, const int* channels, int numChannels,
+                  int numSamples, int numPoints);
+    int decimate(const float* const* source, float* const* dest, const int* channels, int numChannels,
+                 int numSamples, int numPoints);
+    void keepHistory(const float* const* source, const int* channels, int numChannels, int numSamples);
+
+    // The last radius samples of the previous frame, per channel, oldest first
+    std::vector<std::array<float, radius>> history;
+
+    std::vector<int> tapStarts, tapPhases; // per output point, upsampling
+    std::vector<int> keep;                 // source index per output point, decimating
+    std::vector<float> extended;           // history, new samples, then the last one repeated
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeResampler)
+};
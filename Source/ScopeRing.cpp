@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    Overwrite-oldest SPSC ring for scope data.
+
+  ==============================================================================
+*/
+
+#include "ScopeRing.h"
+
+//==============================================================================
+ScopeRing::ScopeRing(int numChannelsToUse, int capacityToUse)
+    : numChannels(juce::jmax(1, numChannelsToUse)),
+      capacity(juce::nextPowerOfTwo(juce::jmax(64, capacityToUse))),
+      mask((juce::uint64)capacity - 1)
+{
+    jassert(numChannels <= 32); // one bit each in silentChannels
+    storage.resize((size_t)numChannels * (size_t)capacity, 0.0f);
+    silentFrom.resize((size_t)numChannels, 0);
+    silentChannels = numChannels < 32 ? (1u << numChannels) - 1 : ~0u;
+}
+
+//==============================================================================
+void ScopeRing::write(const float* const* channels, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    // Anything older than one ring's worth would be overwritten straight away
+    const int skip = juce::jmax(0, numSamples - capacity);
+    const int num = numSamples - skip;
+
+    const auto start = writeEnd.load(std::memory_order_relaxed) + (juce::uint64)skip;
+    const auto end = start + (juce::uint64)num;
+
+    writeReserve.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const int index = (int)(start & mask);
+    const int size1 = juce::jmin(num, capacity - index);
+    const int size2 = num - size1;
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        auto* dest = channel(c);
+        const float* src = channels[c];
+        const auto bit = 1u << c;
+
+        if (src != nullptr)
+        {
+            std::memcpy(dest + index, src + skip, (size_t)size1 * sizeof(float));
+
+            if (size2 > 0)
+                std::memcpy(dest, src + skip + size1, (size_t)size2 * sizeof(float));
+
+            silentChannels &= ~bit;
+            silentFrom[(size_t)c] = end;
+        }
+        else if ((silentChannels & bit) == 0)
+        {
+            // Gone silent: zeros over [start, end) like any other write, so
+            // readers' intact ranges hold, until a whole ring of them is in
+            juce::FloatVectorOperations::clear(dest + index, size1);
+
+            if (size2 > 0)
+                juce::FloatVectorOperations::clear(dest, size2);
+
+            if (end - silentFrom[(size_t)c] >= (juce::uint64)capacity)
+                silentChannels |= bit;
+        }
+    }
+
+    writeEnd.store(end, std::memory_order_release);
+}
+
+//==============================================================================
+int ScopeRing::readNew(float* const* dest, int maxSamples, juce::uint64* numSkipped) noexcept
+{
+    auto position = readPosition.load(std::memory_order_relaxed);
+    const int num = read(position, dest, maxSamples, numSkipped);
+    readPosition.store(position, std::memory_order_release);
+    return num;
+}
+
+juce::uint64 ScopeRing::getNumPending() const noexcept
+{
+    return writeEnd.load(std::memory_order_acquire) - readPosition.load(std::memory_order_acquire);
+}
+
+int ScopeRing::readLatest(float* const* dest, int numSamples) const noexcept
+{
+    const auto end = writeEnd.load(std::memory_order_acquire);
+    const auto available = juce::jmin(end, (juce::uint64)juce::jlimit(0, capacity, numSamples));
+    return copyRange(end - available, end, dest);
+}
+
+int ScopeRing::read(juce::uint64& position, float* const* dest, int maxSamples, juce::uint64* numSkipped) const noexcept
+{
+    const auto end = writeEnd.load(std::memory_order_acquire);
+    const auto limit = (juce::uint64)juce::jlimit(0, capacity, maxSamples);
+    const auto pending = end - juce::jmin(position, end);
+
+    // Latest window: skip whatever backlog doesn't fit rather than lagging behind
+    const auto start = end - juce::jmin(pending, limit);
+
+    position = end;
+    const int num = copyRange(start, end, dest);
+
+    if (numSkipped != nullptr)
+        *numSkipped = pending - (juce::uint64)num;
+
+    return num;
+}
+
+//==============================================================================
+int ScopeRing::copyRange(juce::uint64 start, juce::uint64 end, float* const* dest) const noexcept
+{
+    int num = (int)(end - start);
+
+    if (num <= 0)
+        return 0;
+
+    const int index = (int)(start & mask);
+    const int size1 = juce::jmin(num, capacity - index);
+    const int size2 = num - size1;
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        if (dest[c] == nullptr)
+            continue;
+
+        std::memcpy(dest[c], channel(c) + index, (size_t)size1 * sizeof(float));
+
+        if (size2 > 0)
+            std::memcpy(dest[c] + size1, channel(c), (size_t)size2 * sizeof(float));
+    }
+
+    // Whatever the writer has reserved since may have landed on the oldest
+    // part of what we just copied; throw that part away.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto reserved = writeReserve.load(std::memory_order_relaxed);
+    const auto oldestIntact = reserved > (juce::uint64)capacity ? reserved - (juce::uint64)capacity : 0;
+
+    if (start < oldestIntact)
+    {
+        const int lost = (int)juce::jmin((juce::uint64)num, oldestIntact - start);
+        num -= lost;
+
+        for (int c = 0; c < numChannels; ++c)
+            if (dest[c] != nullptr && num > 0)
+                std::memmove(dest[c], dest[c] + lost, (size_t)num * sizeof(float));
+    }
+
+    return num;
+}
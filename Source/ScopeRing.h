@@ -0,0 +1,78 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Single-producer ring buffer for scope data with "overwrite oldest" semantics.
+//
+// The audio thread always writes, in O(1) per sample, and never waits for a
+// reader: once the ring is full the oldest samples are overwritten. Readers
+// never see stale backlog either - a read that is further behind than it
+// asks for skips straight to the newest samples.
+//
+// Positions are 64-bit running sample counts. The writer's counters and the
+// main consumer's counter live on separate cache lines so the audio thread
+// and the UI thread don't invalidate each other's line on every update.
+class ScopeRing
+{
+public:
+    // capacity is rounded up to a power of two
+    ScopeRing(int numChannels, int capacity);
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getCapacity() const noexcept { return capacity; }
+
+    //==============================================================================
+    // Producer (audio thread). Null channel pointers write silence: zeros go
+    // in as usual until a whole ring's worth has, then the channel is left
+    // alone until it is written again, so channels nobody publishes cost
+    // nothing per block.
+    void write(const float* const* channels, int numSamples) noexcept;
+
+    juce::uint64 getWritePosition() const noexcept { return writeEnd.load(std::memory_order_acquire); }
+
+    //==============================================================================
+    // Main consumer: samples written since its last call, but never more than
+    // the newest maxSamples. Null destination channels are skipped. If given,
+    // numSkipped receives how many unread samples were passed over.
+    int readNew(float* const* dest, int maxSamples, juce::uint64* numSkipped = nullptr) noexcept;
+
+    // Samples the main consumer hasn't read yet (may exceed the capacity).
+    juce::uint64 getNumPending() const noexcept;
+
+    // Main consumer, before it starts reading: passes over everything written
+    // so far, so the first read doesn't count it as skipped.
+    void skipToNewest() noexcept { readPosition.store(writeEnd.load(std::memory_order_acquire), std::memory_order_release); }
+
+    // Any thread, non-consuming: the most recent numSamples (fewer if the
+    // ring hasn't seen that many yet).
+    int readLatest(float* const* dest, int numSamples) const noexcept;
+
+    // Any thread, with a cursor owned by the caller. Same skip-to-newest
+    // behaviour as readNew; position is advanced past what was returned.
+    int read(juce::uint64& position, float* const* dest, int maxSamples, juce::uint64* numSkipped = nullptr) const noexcept;
+
+private:
+    // Copies [start, end) and drops any prefix the writer overwrote meanwhile.
+    int copyRange(juce::uint64 start, juce::uint64 end, float* const* dest) const noexcept;
+
+    float* channel(int index) noexcept { return storage.data() + (size_t)index * (size_t)capacity; }
+    const float* channel(int index) const noexcept { return storage.data() + (size_t)index * (size_t)capacity; }
+
+    const int numChannels;
+    const int capacity;
+    const juce::uint64 mask;
+    std::vector<float> storage;
+
+    // Writer side: writeReserve is bumped before samples are written, writeEnd
+    // after, so a reader can tell which of the samples it copied are intact.
+    alignas(64) std::atomic<juce::uint64> writeReserve{ 0 };
+    std::atomic<juce::uint64> writeEnd{ 0 };
+    juce::uint32 silentChannels = 0;     // bit N: channel N is all zeros
+    std::vector<juce::uint64> silentFrom; // per channel: where its zeros start
+
+    // Main consumer side
+    alignas(64) std::atomic<juce::uint64> readPosition{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeRing)
+};
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    A processor's scope ring and its viewers.
+
+  ==============================================================================
+*/
+
+#include "ScopeStream.h"
+
+namespace
+{
+    std::atomic<int> nextStreamId{ 1 };
+}
+
+//==============================================================================
+ScopeStream::ScopeStream(int maxChannelsToUse, int ringSizeToUse, const juce::String& baseName)
+    : maxChannels(juce::jmax(1, maxChannelsToUse)),
+      ringSize(ringSizeToUse),
+      id(nextStreamId.fetch_add(1)),
+      name(baseName + " #" + juce::String(id)),
+      nextChannels(maxChannels),
+      ringChannels(maxChannels)
+{
+}
+
+//==============================================================================
+void ScopeStream::attachViewer()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (numViewers++ > 0)
+        return;
+
+    // Storage only exists while someone is watching; allocated here, never on the audio thread
+    ringChannels.store(nextChannels.load());
+    ring = std::make_unique<ScopeRing>(ringChannels.load(), ringSize);
+    attached.store(true, std::memory_order_seq_cst);
+}
+
+void ScopeStream::detachViewer()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    jassert(numViewers > 0);
+
+    if (--numViewers > 0)
+        return;
+
+    attached.store(false, std::memory_order_seq_cst);
+
+    // At most one block's worth of waiting
+    while (writing.load(std::memory_order_seq_cst))
+        juce::Thread::yield();
+
+    ring.reset();
+}
+
+//==============================================================================
+bool ScopeStream::beginWrite() noexcept
+{
+    if (! attached.load(std::memory_order_acquire))
+        return false;
+
+    // Dekker-style handshake with detachViewer(): either it sees us writing
+    // and waits, or we see the detach and leave the ring alone.
+    writing.store(true, std::memory_order_seq_cst);
+
+    if (attached.load(std::memory_order_seq_cst))
+        return true;
+
+    writing.store(false, std::memory_order_release);
+    return false;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScopeRing.h"
+
+//==============================================================================
+// One processor's published scope data: the ring plus the viewer bookkeeping
+// that decides whether the audio thread writes to it at all.
+//
+// Reference counted so that an editor overlaying another instance can keep
+// reading safely even if that instance is deleted; the stream is then marked
+// orphaned and simply stops receiving samples.
+class ScopeStream : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<ScopeStream>;
+
+    // The display name is the base name plus a process-unique number, e.g.
+    // "Zubnetic #3". maxChannels bounds setNumChannels(), which it starts at.
+    ScopeStream(int maxChannels, int ringSize, const juce::String& baseName);
+
+    // Any thread. Channels the ring is allocated with the next time a first
+    // viewer attaches; a ring in use keeps its size until all have detached.
+    void setNumChannels(int numChannels) noexcept { nextChannels.store(juce::jlimit(1, maxChannels, numChannels)); }
+
+    // Any thread. Channels of the ring while there is one, else of the next.
+    int getNumChannels() const noexcept { return hasViewers() ? ringChannels.load() : nextChannels.load(); }
+
+    //==============================================================================
+    // Message thread. The ring is allocated when the first viewer attaches and
+    // released when the last one detaches.
+    void attachViewer();
+    void detachViewer();
+
+    // Valid while the calling viewer is attached.
+    ScopeRing* getRing() const noexcept { return ring.get(); }
+
+    //==============================================================================
+    // Audio thread. When beginWrite() returns true the ring may be written
+    // until the matching endWrite(); when false nobody is watching.
+    bool beginWrite() noexcept;
+    void endWrite() noexcept { writing.store(false, std::memory_order_release); }
+
+    bool hasViewers() const noexcept { return attached.load(std::memory_order_relaxed); }
+
+    // Which channel pairs the owner is publishing (bit N = pair N), so that
+    // overlaying editors draw the same ones
+    void setPairMask(juce::uint32 mask) noexcept { pairMask.store(mask, std::memory_order_relaxed); }
+    juce::uint32 getPairMask() const noexcept { return pairMask.load(std::memory_order_relaxed); }
+
+    // Bumped by the audio thread for every written block that isn't silent,
+    // so viewers can tell a live signal from a stopped transport's zeros
+    void noteSignal() noexcept { signalCount.fetch_add(1, std::memory_order_relaxed); }
+    juce::uint32 getSignalCount() const noexcept { return signalCount.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    int getId() const noexcept { return id; }
+    const juce::String& getName() const noexcept { return name; }
+
+    // Set once the owning processor has gone away.
+    void markOrphaned() noexcept { orphaned.store(true); }
+    bool isOrphaned() const noexcept { return orphaned.load(); }
+
+private:
+    const int maxChannels, ringSize, id;
+    const juce::String name;
+
+    std::unique_ptr<ScopeRing> ring;
+    int numViewers = 0;
+
+    std::atomic<bool> attached{ false };
+    std::atomic<bool> writing{ false };
+    std::atomic<bool> orphaned{ false };
+    std::atomic<juce::uint32> pairMask{ 1 };
+    std::atomic<juce::uint32> signalCount{ 0 };
+    std::atomic<int> nextChannels, ringChannels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeStream)
+};
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+    Point transform kernels for the scope renderer.
+
+  ==============================================================================
+*/
+
+#include "ScopeTransform.h"
+
+namespace
+{
+    using namespace ScopeTransform;
+
+    // Angles come from rotating a phasor, re-seeded this often to stop drift
+    constexpr int phasorBlock = 256;
+
+    template <int WaveType>
+    inline float waveModulation(float phase) noexcept
+    {
+        if constexpr (WaveType == triangleWave)
+            return phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase;
+        else if constexpr (WaveType == squareWave)
+            return phase < 0.5f ? 1.0f : -1.0f;
+        else if constexpr (WaveType == sawtoothWave)
+            return 2.0f * phase - 1.0f;
+        else
+            return std::sin(phase * juce::MathConstants<float>::twoPi);
+    }
+
+    template <int ShapeType, int WaveType>
+    void unitShapeKernel(float wraps, int numSamples, int numPoints, float* unitX, float* unitY) noexcept
+    {
+        const double turnsPerSample = (double)wraps / (double)numSamples;
+        const double step = juce::MathConstants<double>::twoPi * turnsPerSample;
+        const float stepCos = (float)std::cos(step), stepSin = (float)std::sin(step);
+
+        for (int blockStart = 0; blockStart < numPoints; blockStart += phasorBlock)
+        {
+            const int blockEnd = juce::jmin(numPoints, blockStart + phasorBlock);
+            float c = (float)std::cos(step * blockStart);
+            float s = (float)std::sin(step * blockStart);
+
+            for (int i = blockStart; i < blockEnd; ++i)
+            {
+                // Position within the current turn
+                const double turns = (double)i * turnsPerSample;
+                const float t = (float)(turns - std::floor(turns));
+                float r = 1.0f;
+
+                if constexpr (ShapeType == starShape)
+                {
+                    // Five lobes per turn, modulated even by the sine wave;
+                    // sin 5a straight from sin a
+                    float modulation;
+
+                    if constexpr (WaveType == sineWave)
+                    {
+                        const float s2 = s * s;
+                        modulation = s * (5.0f + s2 * (-20.0f + 16.0f * s2));
+                    }
+                    else
+                    {
+                        const float lobe = 5.0f * t;
+                        modulation = waveModulation<WaveType>(lobe - std::floor(lobe));
+                    }
+
+                    r = 1.0f + 2.0f * modulation;
+                }
+                else if constexpr (WaveType != sineWave)
+                {
+                    // The other shapes only wobble for the non-sine waves
+                    r = 1.0f + (ShapeType == squareShape ? 0.4f : 0.3f) * waveModulation<WaveType>(t);
+                }
+
+                if constexpr (ShapeType == squareShape)
+                {
+                    // Walk the four sides, one per quarter turn
+                    float x, y;
+
+                    if (t < 0.25f)      { x = 1.0f;                y = 8.0f * t - 1.0f; }
+                    else if (t < 0.5f)  { x = 3.0f - 8.0f * t;     y = 1.0f; }
+                    else if (t < 0.75f) { x = -1.0f;               y = 5.0f - 8.0f * t; }
+                    else                { x = 8.0f * t - 7.0f;     y = -1.0f; }
+
+                    unitX[i] = x * r;
+                    unitY[i] = y * r;
+                }
+                else
+                {
+                    if constexpr (ShapeType == spiralShape)
+                        r *= 1.0f + 0.5f * (float)i / (float)numSamples;
+
+                    unitX[i] = c * r;
+                    unitY[i] = s * r;
+                }
+
+                const float nextC = c * stepCos - s * stepSin;
+                s = s * stepCos + c * stepSin;
+                c = nextC;
+            }
+        }
+    }
+
+    using UnitShapeKernel = void (*)(float, int, int, float*, float*) noexcept;
+
+    template <int ShapeType>
+    constexpr std::array<UnitShapeKernel, numWaves> kernelsForShape()
+    {
+        return { &unitShapeKernel<ShapeType, sineWave>,
+                 &unitShapeKernel<ShapeType, triangleWave>,
+                 &unitShapeKernel<ShapeType, squareWave>,
+                 &unitShapeKernel<ShapeType, sawtoothWave> };
+    }
+
+    constexpr std::array<std::array<UnitShapeKernel, numWaves>, numShapes> unitShapeKernels
+    {
+        kernelsForShape<circleShape>(),
+        kernelsForShape<starShape>(),
+        kernelsForShape<squareShape>(),
+        kernelsForShape<spiralShape>()
+    };
+}
+
+//==============================================================================
+void ScopeTransform::computeUnitShape(int shape, int wave, float wraps, int numSamples, float* unitX, float* unitY,
+                                      int numPoints) noexcept
+{
+    if (numPoints < 0)
+        numPoints = numSamples;
+
+    if (numSamples <= 0)
+        return;
+
+    // Out-of-range values fall back to a plain circle
+    if (! juce::isPositiveAndBelow(shape, (int)numShapes) || ! juce::isPositiveAndBelow(wave, (int)numWaves))
+    {
+        shape = circleShape;
+        wave = sineWave;
+    }
+
+    unitShapeKernels[(size_t)shape][(size_t)wave](wraps, numSamples, numPoints, unitX, unitY);
+}
+
+//==============================================================================
+void ScopeTransform::UnitShapeCache::setPattern(int newShape, int newWave, float newWraps)
+{
+    shape = newShape;
+    wave = newWave;
+    wraps = newWraps;
+    hasPattern = true;
+
+    computedSize = 0;
+}
+
+void ScopeTransform::UnitShapeCache::getUnitShape(int numSamples, const float*& x, const float*& y)
+{
+    jassert(hasPattern); // setPattern() first
+
+    // Computed, not interpolated from a table, so square and saw edges and
+    // star corners stay as sharp as the kernels make them at any wrap count
+    if (numSamples != computedSize)
+    {
+        unitX.resize((size_t)juce::jmax(1, numSamples));
+        unitY.resize((size_t)juce::jmax(1, numSamples));
+        computeUnitShape(shape, wave, wraps, numSamples, unitX.data(), unitY.data());
+
+        computedSize = numSamples;
+    }
+
+    x = unitX.data();
+    y = unitY.data();
+}
+
+void ScopeTransform::computeSideOffsets(float* dest, int numSamples, float amount, float& phase) noexcept
+{
+    const float step = 0.001f * std::abs(amount);
+
+    if (amount == 0.0f)
+    {
+        juce::FloatVectorOperations::clear(dest, numSamples);
+        return;
+    }
+
+    // One sin/cos per call, then a rotating phasor
+    const float stepCos = std::cos(step), stepSin = std::sin(step);
+    float c = std::cos(phase), s = std::sin(phase);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        dest[i] = amount * s;
+
+        const float nextC = c * stepCos - s * stepSin;
+        s = s * stepCos + c * stepSin;
+        c = nextC;
+    }
+
+    // Kept within one turn so float precision doesn't run out over time
+    phase = std::fmod(phase + step * (float)numSamples, juce::MathConstants<float>::twoPi);
+}
+
+void ScopeTransform::mapPoints(const Mapping& m, const float* left, const float* right, const float* sideOffsets,
+                               const float* unitX, const float* unitY, float* x, float* y, int numSamples) noexcept
+{
+    // Branch-free over plain arrays: the compiler vectorises this
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float mid = 0.5f * (left[i] + right[i]);
+        const float side = (0.5f * (left[i] - right[i]) + sideOffsets[i]) * m.sideGain;
+
+        const float px = (mid + side) * m.stereoGain + mid * unitX[i] * m.patternGain;
+        const float py = (mid - side) * m.stereoGain + mid * unitY[i] * m.patternGain;
+
+        x[i] = m.centreX + (px * m.cosAngle - py * m.sinAngle) * m.scale;
+        y[i] = m.centreY - (px * m.sinAngle + py * m.cosAngle) * m.scale;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Sample-to-screen transform of the scope, independent of how points get
+// drawn. Works on structure-of-arrays buffers so the loops vectorise.
+//
+// The mono pattern (circle, star, ...) only depends on a sample's position in
+// the frame, never on its value, so it is computed once per frame as a unit
+// shape; mapping a chunk of samples is then the same straight-line arithmetic
+// for every shape.
+namespace ScopeTransform
+{
+    // Values of the monoShape and waveType parameters
+    enum Shape { circleShape = 0, starShape, squareShape, spiralShape, numShapes };
+    enum Wave { sineWave = 0, triangleWave, squareWave, sawtoothWave, numWaves };
+
+    // Fills unitX/unitY with the mono pattern at unit radius for each of
+    // numSamples samples, wraps turns across the frame. Dispatches once to a
+    // kernel compiled for this shape and wave. numPoints, if given, may run
+    // past numSamples to continue the pattern beyond the end of the frame.
+    void computeUnitShape(int shape, int wave, float wraps, int numSamples, float* unitX, float* unitY,
+                          int numPoints = -1) noexcept;
+
+    // The unit shape computed exactly for a frame's sample count, and kept
+    // until the pattern or the count changes; with a steady block size or a
+    // point budget, that's once.
+    class UnitShapeCache
+    {
+    public:
+        UnitShapeCache() = default;
+
+        void setPattern(int shape, int wave, float wraps);
+
+        // Valid until the next call
+        void getUnitShape(int numSamples, const float*& x, const float*& y);
+
+    private:
+        int shape = circleShape, wave = sineWave;
+        float wraps = 1.0f;
+        bool hasPattern = false;
+
+        std::vector<float> unitX, unitY;
+        int computedSize = 0; // 0 while nothing valid is cached
+
+        JUCE_DECLARE_NON_COPYABLE(UnitShapeCache)
+    };
+
+    // The "DC offset" wobble: dest[i] = amount * sin(phase), phase advancing
+    // 0.001 * |amount| per sample. Carries phase over to the next call.
+    void computeSideOffsets(float* dest, int numSamples, float amount, float& phase) noexcept;
+
+    // Per-chunk constants of the mapping
+    struct Mapping
+    {
+        float sideGain = 1.0f;    // mono amount and spread
+        float stereoGain = 1.0f;  // share of the plain XY picture
+        float patternGain = 0.0f; // share of the mono pattern, scaled by mid
+        float cosAngle = 1.0f, sinAngle = 0.0f;
+        float centreX = 0.0f, centreY = 0.0f, scale = 1.0f;
+    };
+
+    // Mid/side from left/right, side wobble and gain, blend with the unit
+    // shape, rotation and placement: x/y in pixels
+    void mapPoints(const Mapping&, const float* left, const float* right, const float* sideOffsets,
+                   const float* unitX, const float* unitY, float* x, float* y, int numSamples) noexcept;
+}
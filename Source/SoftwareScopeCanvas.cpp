@@ -0,0 +1,682 @@
+/*
+  ==============================================================================
+
+    Float HDR software rasterizer for the scope renderer.
+
+  ==============================================================================
+*/
+
+#include "SoftwareScopeCanvas.h"
+
+namespace
+{
+    constexpr int planeAlignment = 32; // bytes, enough for AVX loads
+    constexpr int rowMultiple = 8;     // floats, so every row starts aligned too
+
+    // Bloom is blurred at 1/2 resolution or less, shrinking further (up to
+    // 1/8) rather than letting the kernel grow past a few taps per sigma
+    constexpr int minBloomFactor = 2;
+    constexpr int maxBloomFactor = 8;
+    constexpr float maxBloomSigma = 4.0f;
+
+    alignas(32) const float laneCentres[8] = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+
+   #if JUCE_USE_SIMD
+    // SIMDRegister has no square root; one per native register type
+    #if JUCE_USE_SSE_INTRINSICS
+     inline __m128 nativeSqrt(__m128 v) noexcept { return _mm_sqrt_ps(v); }
+    #endif
+    #if defined(__AVX__)
+     inline __m256 nativeSqrt(__m256 v) noexcept { return _mm256_sqrt_ps(v); }
+    #endif
+    #if JUCE_USE_ARM_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+     inline float32x4_t nativeSqrt(float32x4_t v) noexcept { return vsqrtq_f32(v); }
+    #elif JUCE_USE_ARM_NEON
+     // ARMv7 has no vector square root: v times its reciprocal square root estimate, refined twice
+     inline float32x4_t nativeSqrt(float32x4_t v) noexcept
+     {
+         float32x4_t e = vrsqrteq_f32(v);
+         e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(v, e), e));
+         e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(v, e), e));
+         return vbslq_f32(vceqq_f32(v, vdupq_n_f32(0.0f)), v, vmulq_f32(v, e));
+     }
+    #endif
+
+    inline juce::dsp::SIMDRegister<float> squareRoot(juce::dsp::SIMDRegister<float> v) noexcept
+    {
+        return juce::dsp::SIMDRegister<float>::fromNative(nativeSqrt(v.value));
+    }
+   #endif
+
+    // log2 from the float's exponent plus a quadratic over the mantissa
+    // (which also supplies the exponent's missing 1): within 0.005 for
+    // normal positive x, and branch-free so it vectorises
+    inline float fastLog2(float x) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        const float exponent = (float)((int)(bits >> 23) - 128);
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        return exponent + (-0.34484843f * mantissa + 2.02466578f) * mantissa - 0.67487759f;
+    }
+}
+
+//==============================================================================
+void SoftwareScopeCanvas::resize(int newWidth, int newHeight)
+{
+    const int oldWidth = width, oldHeight = height, oldStride = stride;
+    const size_t oldPlaneSize = planeSize;
+    const float* oldBase = planeBase;
+    std::vector<float> oldStorage;
+    oldStorage.swap(storage);
+
+    width = newWidth;
+    height = newHeight;
+    stride = (width + rowMultiple - 1) / rowMultiple * rowMultiple;
+    planeSize = (size_t)stride * (size_t)height;
+
+    storage.assign(3 * planeSize + planeAlignment / sizeof(float), 0.0f);
+    planeBase = juce::snapPointerToAlignment(storage.data(), planeAlignment);
+
+    // The trails so far, stretched bilinearly onto the new size: both window
+    // resizes and the quality governor's resolution steps keep the picture's
+    // proportions, so a step doesn't blank what's still fading
+    if (oldWidth > 0 && oldHeight > 0 && width > 0 && height > 0)
+    {
+        std::vector<int> columns((size_t)width);
+        std::vector<float> columnWeights((size_t)width);
+
+        for (int x = 0; x < width; ++x)
+        {
+            const float fx = juce::jlimit(0.0f, (float)(oldWidth - 1), ((float)x + 0.5f) * (float)oldWidth / (float)width - 0.5f);
+            columns[(size_t)x] = (int)fx;
+            columnWeights[(size_t)x] = fx - (float)(int)fx;
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            const float fy = juce::jlimit(0.0f, (float)(oldHeight - 1), ((float)y + 0.5f) * (float)oldHeight / (float)height - 0.5f);
+            const int y0 = (int)fy;
+            const int y1 = juce::jmin(y0 + 1, oldHeight - 1);
+            const float ty = fy - (float)y0;
+
+            for (int c = 0; c < 3; ++c)
+            {
+                const float* row0 = oldBase + (size_t)c * oldPlaneSize + (size_t)y0 * (size_t)oldStride;
+                const float* row1 = oldBase + (size_t)c * oldPlaneSize + (size_t)y1 * (size_t)oldStride;
+                float* out = plane(c) + (size_t)y * (size_t)stride;
+
+                for (int x = 0; x < width; ++x)
+                {
+                    const int i = columns[(size_t)x];
+                    const int j = juce::jmin(i + 1, oldWidth - 1);
+                    const float tx = columnWeights[(size_t)x];
+                    const float top = row0[i] + (row0[j] - row0[i]) * tx;
+                    const float bottom = row1[i] + (row1[j] - row1[i]) * tx;
+                    out[x] = top + (bottom - top) * ty;
+                }
+            }
+        }
+    }
+
+    toneRow.resize((size_t)stride * 3);
+    curveRow.resize((size_t)stride);
+    bloomRow.assign((size_t)stride * 3, 0.0f);
+}
+
+void SoftwareScopeCanvas::beginFrame(int newWidth, int newHeight, float fadeAlpha)
+{
+    if (newWidth != width || newHeight != height)
+        resize(newWidth, newHeight);
+
+    clip = { 0, 0, width, height };
+    bloomStrength = 0.0f;
+    densityGain = 0.0f;
+
+    // Persistence: everything already there decays towards black
+    juce::FloatVectorOperations::multiply(planeBase, 1.0f - fadeAlpha, (int)(3 * planeSize));
+}
+
+void SoftwareScopeCanvas::setClip(juce::Rectangle<float> area)
+{
+    clip = area.toNearestInt().getIntersection({ 0, 0, width, height });
+}
+
+void SoftwareScopeCanvas::drawSegment(juce::Point<float> start, juce::Point<float> end, float thickness, juce::Colour colour)
+{
+    addCapsule(start, end, 0.5f * thickness, colour);
+}
+
+void SoftwareScopeCanvas::drawDot(juce::Point<float> centre, float diameter, juce::Colour colour)
+{
+    if (diameter <= maxStampDiameter)
+        addStamp(centre, 0.5f * diameter, colour);
+    else
+        addCapsule(centre, centre, 0.5f * diameter, colour);
+}
+
+void SoftwareScopeCanvas::setBloom(float strength, float radius)
+{
+    bloomStrength = juce::jmax(0.0f, strength);
+    bloomRadius = juce::jmax(0.0f, radius);
+}
+
+void SoftwareScopeCanvas::setDensityCurve(float amount)
+{
+    // Gain from 0 (linear) to 1023, normalised so light of 1 stays 1
+    densityGain = std::exp2(10.0f * juce::jlimit(0.0f, 1.0f, amount)) - 1.0f;
+    densityNorm = densityGain > 0.0f ? 1.0f / std::log2(1.0f + densityGain) : 1.0f;
+}
+
+void SoftwareScopeCanvas::drawBeam(const float* x, const float* y, const juce::Colour* colours, int numPoints)
+{
+    if (clip.isEmpty())
+        return;
+
+    float* r = plane(0);
+    float* g = plane(1);
+    float* b = plane(2);
+
+    auto addLight = [&](int px, int py, float red, float green, float blue)
+        {
+            if (clip.contains(px, py))
+            {
+                const size_t i = (size_t)py * (size_t)stride + (size_t)px;
+                r[i] += red;
+                g[i] += green;
+                b[i] += blue;
+            }
+        };
+
+    for (int i = 0; i + 1 < numPoints; ++i)
+    {
+        const float alpha = colours[i].getFloatAlpha();
+
+        if (alpha <= 0.0f)
+            continue;
+
+        // One step's light, shared by splats about a pixel apart
+        const float dx = x[i + 1] - x[i];
+        const float dy = y[i + 1] - y[i];
+        const int numSplats = juce::jlimit(1, maxBeamSplats, (int)std::ceil(std::sqrt(dx * dx + dy * dy)));
+        const float share = alpha / (float)numSplats;
+        const float red = colours[i].getFloatRed() * share;
+        const float green = colours[i].getFloatGreen() * share;
+        const float blue = colours[i].getFloatBlue() * share;
+
+        for (int s = 0; s < numSplats; ++s)
+        {
+            // Bilinear over the four pixels around the point (pixel centres at .5)
+            const float t = ((float)s + 0.5f) / (float)numSplats;
+            const float sx = x[i] + t * dx - 0.5f;
+            const float sy = y[i] + t * dy - 0.5f;
+            const float fx = std::floor(sx), fy = std::floor(sy);
+            const int px = (int)fx, py = (int)fy;
+            const float wx = sx - fx, wy = sy - fy;
+
+            const float w00 = (1.0f - wx) * (1.0f - wy), w10 = wx * (1.0f - wy);
+            const float w01 = (1.0f - wx) * wy, w11 = wx * wy;
+
+            addLight(px, py, red * w00, green * w00, blue * w00);
+            addLight(px + 1, py, red * w10, green * w10, blue * w10);
+            addLight(px, py + 1, red * w01, green * w01, blue * w01);
+            addLight(px + 1, py + 1, red * w11, green * w11, blue * w11);
+        }
+    }
+}
+
+//==============================================================================
+void SoftwareScopeCanvas::addCapsule(juce::Point<float> a, juce::Point<float> b, float radius, juce::Colour colour) noexcept
+{
+    const float alpha = colour.getFloatAlpha();
+
+    if (alpha <= 0.0f || clip.isEmpty())
+        return;
+
+    // Coverage ramps over one pixel around the edge
+    const float reach = juce::jmax(0.5f, radius) + 0.5f;
+
+    const float dx = b.x - a.x;
+    const float dy = b.y - a.y;
+    const float lengthSq = dx * dx + dy * dy;
+    const float invLengthSq = lengthSq > 1.0e-6f ? 1.0f / lengthSq : 0.0f;
+
+    const float red = colour.getFloatRed() * alpha;
+    const float green = colour.getFloatGreen() * alpha;
+    const float blue = colour.getFloatBlue() * alpha;
+
+    const int yStart = juce::jmax(clip.getY(), (int)std::floor(juce::jmin(a.y, b.y) - reach));
+    const int yEnd = juce::jmin(clip.getBottom(), (int)std::ceil(juce::jmax(a.y, b.y) + reach));
+
+    for (int y = yStart; y < yEnd; ++y)
+    {
+        // Only the part of the centre line within reach of this row can touch it
+        const float py = (float)y + 0.5f;
+        float lo, hi;
+
+        if (std::abs(dy) > 1.0e-3f)
+        {
+            const float t0 = juce::jlimit(0.0f, 1.0f, (py - reach - a.y) / dy);
+            const float t1 = juce::jlimit(0.0f, 1.0f, (py + reach - a.y) / dy);
+            lo = a.x + juce::jmin(t0, t1) * dx;
+            hi = a.x + juce::jmax(t0, t1) * dx;
+
+            if (lo > hi)
+                std::swap(lo, hi);
+        }
+        else
+        {
+            lo = juce::jmin(a.x, b.x);
+            hi = juce::jmax(a.x, b.x);
+        }
+
+        const int xStart = juce::jmax(clip.getX(), (int)std::floor(lo - reach));
+        const int xEnd = juce::jmin(clip.getRight(), (int)std::ceil(hi + reach));
+
+        if (xStart < xEnd)
+            addCapsuleRow(y, xStart, xEnd, a.x, a.y, dx, dy, invLengthSq, reach, red, green, blue);
+    }
+}
+
+void SoftwareScopeCanvas::addStamp(juce::Point<float> centre, float radius, juce::Colour colour) noexcept
+{
+    const float alpha = colour.getFloatAlpha();
+
+    if (alpha <= 0.0f || clip.isEmpty())
+        return;
+
+    // Diameter and position within the pixel, both to a quarter pixel
+    const int sizeIndex = juce::roundToInt(2.0f * radius * (float)stampPhases);
+    const int cellX = (int)std::floor(centre.x);
+    const int cellY = (int)std::floor(centre.y);
+    const int phaseX = juce::jlimit(0, stampPhases - 1, (int)((centre.x - (float)cellX) * (float)stampPhases));
+    const int phaseY = juce::jlimit(0, stampPhases - 1, (int)((centre.y - (float)cellY) * (float)stampPhases));
+
+    const auto numStamps = (size_t)(juce::roundToInt(maxStampDiameter * (float)stampPhases) + 1) * stampPhases * stampPhases;
+
+    if (stamps.size() != numStamps)
+        stamps.resize(numStamps);
+
+    auto& stamp = stamps[((size_t)sizeIndex * stampPhases + (size_t)phaseY) * stampPhases + (size_t)phaseX];
+
+    if (stamp.size == 0)
+    {
+        // The same coverage as a zero-length capsule, see addCapsuleRow()
+        const float quantisedRadius = (float)sizeIndex / (2.0f * (float)stampPhases);
+        const float reach = juce::jmax(0.5f, quantisedRadius) + 0.5f;
+        const float fx = ((float)phaseX + 0.5f) / (float)stampPhases;
+        const float fy = ((float)phaseY + 0.5f) / (float)stampPhases;
+
+        stamp.offset = -(int)std::ceil(reach);
+        stamp.size = 2 * (int)std::ceil(reach) + 1;
+        stamp.coverage.resize((size_t)(stamp.size * stamp.size));
+
+        for (int j = 0; j < stamp.size; ++j)
+        {
+            for (int i = 0; i < stamp.size; ++i)
+            {
+                const float ex = (float)(stamp.offset + i) + 0.5f - fx;
+                const float ey = (float)(stamp.offset + j) + 0.5f - fy;
+                stamp.coverage[(size_t)(j * stamp.size + i)] = juce::jlimit(0.0f, 1.0f, reach - std::sqrt(ex * ex + ey * ey));
+            }
+        }
+    }
+
+    const int left = cellX + stamp.offset;
+    const int top = cellY + stamp.offset;
+    const int x0 = juce::jmax(clip.getX(), left);
+    const int x1 = juce::jmin(clip.getRight(), left + stamp.size);
+    const int y0 = juce::jmax(clip.getY(), top);
+    const int y1 = juce::jmin(clip.getBottom(), top + stamp.size);
+
+    if (x0 >= x1)
+        return;
+
+    const float red = colour.getFloatRed() * alpha;
+    const float green = colour.getFloatGreen() * alpha;
+    const float blue = colour.getFloatBlue() * alpha;
+
+    for (int y = y0; y < y1; ++y)
+    {
+        const size_t row = (size_t)y * (size_t)stride + (size_t)x0;
+        const float* mask = stamp.coverage.data() + (size_t)((y - top) * stamp.size + (x0 - left));
+
+        juce::FloatVectorOperations::addWithMultiply(plane(0) + row, mask, red, x1 - x0);
+        juce::FloatVectorOperations::addWithMultiply(plane(1) + row, mask, green, x1 - x0);
+        juce::FloatVectorOperations::addWithMultiply(plane(2) + row, mask, blue, x1 - x0);
+    }
+}
+
+void SoftwareScopeCanvas::addCapsuleRow(int y, int x0, int x1, float ax, float ay, float dx, float dy, float invLengthSq,
+                                        float reach, float red, float green, float blue) noexcept
+{
+    float* r = plane(0) + (size_t)y * (size_t)stride;
+    float* g = plane(1) + (size_t)y * (size_t)stride;
+    float* b = plane(2) + (size_t)y * (size_t)stride;
+
+    const float ry = (float)y + 0.5f - ay;
+    int x = x0;
+
+    // Coverage is (reach - d) for distance d to the segment: full across the
+    // stroke's width, falling to nothing over the pixel beyond its edge
+    auto addPixel = [&](int px)
+        {
+            const float rx = (float)px + 0.5f - ax;
+            const float t = juce::jlimit(0.0f, 1.0f, (rx * dx + ry * dy) * invLengthSq);
+            const float ex = rx - t * dx;
+            const float ey = ry - t * dy;
+            const float coverage = juce::jlimit(0.0f, 1.0f, reach - std::sqrt(ex * ex + ey * ey));
+
+            r[px] += coverage * red;
+            g[px] += coverage * green;
+            b[px] += coverage * blue;
+        };
+
+   #if JUCE_USE_SIMD
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = (int)Vec::SIMDNumElements;
+    static_assert(lanes <= (int)juce::numElementsInArray(laneCentres), "lane table too short");
+
+    // Scalar head until the loads are aligned (rows of all planes align alike)
+    while (x < x1 && ! Vec::isSIMDAligned(r + x))
+        addPixel(x++);
+
+    const auto zero = Vec::expand(0.0f);
+    const auto one = Vec::expand(1.0f);
+    const auto centres = Vec::fromRawArray(laneCentres);
+    const auto vdx = Vec::expand(dx), vdy = Vec::expand(dy), vry = Vec::expand(ry);
+    const auto rowDot = Vec::expand(ry * dy);
+    const auto vInvLengthSq = Vec::expand(invLengthSq);
+    const auto vReach = Vec::expand(reach);
+    const auto vRed = Vec::expand(red), vGreen = Vec::expand(green), vBlue = Vec::expand(blue);
+
+    for (; x + lanes <= x1; x += lanes)
+    {
+        const auto rx = centres + Vec::expand((float)x - ax);
+        const auto t = Vec::min(one, Vec::max(zero, (rx * vdx + rowDot) * vInvLengthSq));
+        const auto ex = rx - t * vdx;
+        const auto ey = vry - t * vdy;
+        const auto coverage = Vec::min(one, Vec::max(zero, vReach - squareRoot(ex * ex + ey * ey)));
+
+        (Vec::fromRawArray(r + x) + coverage * vRed).copyToRawArray(r + x);
+        (Vec::fromRawArray(g + x) + coverage * vGreen).copyToRawArray(g + x);
+        (Vec::fromRawArray(b + x) + coverage * vBlue).copyToRawArray(b + x);
+    }
+   #endif
+
+    for (; x < x1; ++x)
+        addPixel(x);
+}
+
+//==============================================================================
+void SoftwareScopeCanvas::endFrame()
+{
+    toneMap();
+
+    const juce::SpinLock::ScopedLockType sl(swapLock);
+    std::swap(writing, ready);
+    std::swap(writingScale, readyScale);
+    readyIsNew = true;
+}
+
+void SoftwareScopeCanvas::toneMap()
+{
+    if (! writing.isValid() || writing.getWidth() != width || writing.getHeight() != height)
+        writing = juce::Image(juce::Image::ARGB, width, height, false);
+
+    const juce::Image::BitmapData dest(writing, juce::Image::BitmapData::writeOnly);
+
+    const bool bloom = bloomStrength > 0.0f && bloomRadius > 0.0f && width > 0 && height > 0;
+
+    if (bloom)
+        buildBloom();
+    else
+        std::fill(bloomRow.begin(), bloomRow.end(), 0.0f);
+
+    for (int y = 0; y < height; ++y)
+    {
+        if (bloom)
+            upsampleBloomRow(y);
+
+        // Density curve: one scale per pixel from its brightest channel, so
+        // compressing the light keeps its hue
+        if (densityGain > 0.0f)
+        {
+            const size_t row = (size_t)y * (size_t)stride;
+            const float* r = plane(0) + row;
+            const float* g = plane(1) + row;
+            const float* b = plane(2) + row;
+            float* scale = curveRow.data();
+
+            for (int x = 0; x < width; ++x)
+            {
+                const float m = juce::jmax(1.0e-6f, r[x], g[x], b[x]);
+                scale[x] = fastLog2(1.0f + densityGain * m) * densityNorm / m;
+            }
+        }
+
+        // 1 - 1 / (1 + x + x^2/2): a cheap, exp-like curve that never clips;
+        // simple enough for the compiler to vectorise
+        for (int c = 0; c < 3; ++c)
+        {
+            const float* src = plane(c) + (size_t)y * (size_t)stride;
+            const float* glow = bloomRow.data() + (size_t)c * (size_t)stride;
+            const float* scale = curveRow.data();
+            float* out = toneRow.data() + (size_t)c * (size_t)stride;
+
+            if (densityGain > 0.0f)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    const float v = (src[x] * scale[x] + glow[x]) * exposure;
+                    out[x] = 255.0f - 255.0f / (1.0f + v + 0.5f * v * v);
+                }
+            }
+            else
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    const float v = (src[x] + glow[x]) * exposure;
+                    out[x] = 255.0f - 255.0f / (1.0f + v + 0.5f * v * v);
+                }
+            }
+        }
+
+        auto* line = reinterpret_cast<juce::PixelARGB*>(dest.getLinePointer(y));
+        const float* red = toneRow.data();
+        const float* green = red + stride;
+        const float* blue = green + stride;
+
+        for (int x = 0; x < width; ++x)
+            line[x].setARGB(255, (juce::uint8)red[x], (juce::uint8)green[x], (juce::uint8)blue[x]);
+    }
+}
+
+//==============================================================================
+void SoftwareScopeCanvas::buildBloom()
+{
+    int factor = minBloomFactor;
+
+    while (factor < maxBloomFactor && bloomRadius / (float)factor > maxBloomSigma)
+        factor *= 2;
+
+    const float sigma = juce::jmax(0.5f, bloomRadius / (float)factor);
+    const int pad = juce::jmax(1, (int)std::ceil(2.5f * sigma));
+    const int lowWidth = (width + factor - 1) / factor;
+    const int lowHeight = (height + factor - 1) / factor;
+
+    // The upsampling tables go with the full width, which can change without
+    // the bloom size changing (599 and 600 px both blur at 300 at factor 2)
+    if (factor != bloomFactor || pad != bloomPad || lowWidth != bloomWidth || lowHeight != bloomHeight
+        || (int)upsampleIndex.size() != width)
+    {
+        bloomFactor = factor;
+        bloomPad = pad;
+        bloomWidth = lowWidth;
+        bloomHeight = lowHeight;
+        bloomStride = lowWidth + 2 * pad;
+        bloomPlaneSize = (size_t)bloomStride * (size_t)(lowHeight + 2 * pad);
+        bloomPlanes.assign(4 * bloomPlaneSize, 0.0f);
+        bloomLine.assign((size_t)lowWidth + 1, 0.0f);
+
+        // Bilinear upsampling, sampling at pixel centres
+        upsampleIndex.resize((size_t)width);
+        upsampleWeight.resize((size_t)width);
+
+        for (int x = 0; x < width; ++x)
+        {
+            const float fx = juce::jlimit(0.0f, (float)(lowWidth - 1), ((float)x + 0.5f) / (float)factor - 0.5f);
+            upsampleIndex[(size_t)x] = (int)fx;
+            upsampleWeight[(size_t)x] = fx - (float)(int)fx;
+        }
+    }
+
+    bloomKernel.resize((size_t)(2 * pad + 1));
+    float kernelSum = 0.0f;
+
+    for (int k = -pad; k <= pad; ++k)
+    {
+        const float w = std::exp(-0.5f * (float)(k * k) / (sigma * sigma));
+        bloomKernel[(size_t)(k + pad)] = w;
+        kernelSum += w;
+    }
+
+    for (auto& w : bloomKernel)
+        w /= kernelSum;
+
+    const size_t rowStride = (size_t)bloomStride;
+    const auto origin = (size_t)pad * rowStride + (size_t)pad; // first interior pixel
+    const float blockScale = 1.0f / (float)(factor * factor);
+    float* scratch = bloomPlane(3);
+
+    for (int c = 0; c < 3; ++c)
+    {
+        float* low = bloomPlane(c);
+
+        // Bright pass, summed over factor x factor blocks
+        for (int ly = 0; ly < lowHeight; ++ly)
+        {
+            float* dst = low + origin + (size_t)ly * rowStride;
+            std::fill(dst, dst + lowWidth, 0.0f);
+
+            const int yEnd = juce::jmin(height, (ly + 1) * factor);
+
+            for (int sy = ly * factor; sy < yEnd; ++sy)
+            {
+                const float* src = plane(c) + (size_t)sy * (size_t)stride;
+
+                for (int lx = 0, x = 0; lx < lowWidth; ++lx)
+                {
+                    float sum = 0.0f;
+
+                    for (const int xEnd = juce::jmin(width, x + factor); x < xEnd; ++x)
+                        sum += juce::jmax(0.0f, src[x] - bloomThreshold);
+
+                    dst[lx] += sum;
+                }
+            }
+        }
+
+        // Horizontal blur into scratch; the block average is folded into the taps
+        for (int ly = 0; ly < lowHeight; ++ly)
+        {
+            const float* in = low + origin + (size_t)ly * rowStride - pad;
+            float* out = scratch + origin + (size_t)ly * rowStride;
+
+            juce::FloatVectorOperations::copyWithMultiply(out, in, bloomKernel[0] * blockScale, lowWidth);
+
+            for (int k = 1; k <= 2 * pad; ++k)
+                juce::FloatVectorOperations::addWithMultiply(out, in + k, bloomKernel[(size_t)k] * blockScale, lowWidth);
+        }
+
+        // Vertical blur back into the plane: whole rows at a time
+        for (int ly = 0; ly < lowHeight; ++ly)
+        {
+            const float* in = scratch + (size_t)ly * rowStride + (size_t)pad;
+            float* out = low + origin + (size_t)ly * rowStride;
+
+            juce::FloatVectorOperations::copyWithMultiply(out, in, bloomKernel[0], lowWidth);
+
+            for (int k = 1; k <= 2 * pad; ++k)
+                juce::FloatVectorOperations::addWithMultiply(out, in + (size_t)k * rowStride, bloomKernel[(size_t)k], lowWidth);
+        }
+    }
+}
+
+void SoftwareScopeCanvas::upsampleBloomRow(int y) noexcept
+{
+    const float fy = juce::jlimit(0.0f, (float)(bloomHeight - 1), ((float)y + 0.5f) / (float)bloomFactor - 0.5f);
+    const int y0 = (int)fy;
+    const int y1 = juce::jmin(y0 + 1, bloomHeight - 1);
+    const float ty = fy - (float)y0;
+
+    const size_t rowStride = (size_t)bloomStride;
+    const auto origin = (size_t)bloomPad * rowStride + (size_t)bloomPad;
+    float* line = bloomLine.data();
+
+    for (int c = 0; c < 3; ++c)
+    {
+        const float* row0 = bloomPlane(c) + origin + (size_t)y0 * rowStride;
+        const float* row1 = bloomPlane(c) + origin + (size_t)y1 * rowStride;
+
+        juce::FloatVectorOperations::copyWithMultiply(line, row0, bloomStrength * (1.0f - ty), bloomWidth);
+        juce::FloatVectorOperations::addWithMultiply(line, row1, bloomStrength * ty, bloomWidth);
+        line[bloomWidth] = line[bloomWidth - 1];
+
+        float* out = bloomRow.data() + (size_t)c * (size_t)stride;
+
+        for (int x = 0; x < width; ++x)
+        {
+            const int i = upsampleIndex[(size_t)x];
+            out[x] = line[i] + (line[i + 1] - line[i]) * upsampleWeight[(size_t)x];
+        }
+    }
+}
+
+//==============================================================================
+void SoftwareScopeCanvas::drawTo(juce::Graphics& g, juce::Rectangle<int> area)
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(swapLock);
+
+        if (readyIsNew)
+        {
+            std::swap(ready, showing);
+            std::swap(readyScale, showingScale);
+            readyIsNew = false;
+        }
+    }
+
+    if (! showing.isValid())
+    {
+        g.setColour(juce::Colours::black);
+        g.fillRect(area);
+        return;
+    }
+
+    // Frames are opaque: no clearing underneath, only around them if smaller
+    auto covered = area.withSize(showing.getWidth(), showing.getHeight());
+
+    if (showingScale == 1.0f)
+    {
+        g.drawImageAt(showing, area.getX(), area.getY());
+    }
+    else
+    {
+        // Rendered at reduced resolution: bilinear upscale to the window size
+        covered.setSize(juce::roundToInt((float)showing.getWidth() / showingScale),
+                        juce::roundToInt((float)showing.getHeight() / showingScale));
+
+        g.setImageResamplingQuality(juce::Graphics::mediumResamplingQuality);
+        g.drawImage(showing, covered.toFloat());
+    }
+
+    g.setColour(juce::Colours::black);
+    g.fillRect(area.withTrimmedLeft(covered.getWidth()));
+    g.fillRect(area.withTrimmedTop(covered.getHeight()).withWidth(juce::jmin(area.getWidth(), covered.getWidth())));
+}
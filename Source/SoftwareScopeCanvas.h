@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScopeCanvas.h"
+
+//==============================================================================
+// The CPU backend: a purpose-built rasterizer for the scope's two shapes.
+//
+// Strokes are drawn as capsules (a segment swept by a disc) with
+// distance-based antialiasing, added straight into three float planes
+// (R, G, B) with SIMD row kernels. Light adds up like it does on a phosphor
+// screen; the HDR result is tone-mapped into an ARGB image once per frame.
+//
+// Dots are stamps: the same antialiased disc, rendered once per quarter
+// pixel of diameter and quarter pixel of position, then added row by row
+// with vector multiply-adds. No distances per pixel, so particle mode can
+// afford a dot for every sample.
+//
+// The phosphor beam splats light bilinearly along each step, so its cost
+// follows the distance travelled, not a stroke's area; with the density
+// curve applied in tone-mapping, every sample can be drawn.
+//
+// Glow is a bloom pass rather than extra geometry: the bright parts are
+// box-downsampled, blurred with a separable Gaussian (row-wise vector adds
+// in both directions) and added back while tone-mapping, so its cost
+// follows the pixel count and not the number of samples drawn.
+//
+// Finished frames reach the message thread through three images, so neither
+// side ever waits for the other's work: the render thread tone-maps into
+// its own image and swaps it with the "ready" one, and paint swaps "ready"
+// with the one it shows. The lock only ever covers those swaps.
+class SoftwareScopeCanvas : public ScopeCanvas
+{
+public:
+    SoftwareScopeCanvas() = default;
+
+    void beginFrame(int width, int height, float fadeAlpha) override;
+    void setClip(juce::Rectangle<float> area) override;
+    void drawSegment(juce::Point<float> start, juce::Point<float> end, float thickness, juce::Colour colour) override;
+    void drawDot(juce::Point<float> centre, float diameter, juce::Colour colour) override;
+    bool hasCheapDots() const noexcept override { return true; }
+    void drawBeam(const float* x, const float* y, const juce::Colour* colours, int numPoints) override;
+    void setDensityCurve(float amount) override;
+    bool supportsBloom() const noexcept override { return true; }
+    void setBloom(float strength, float radius) override;
+    void endFrame() override;
+
+    // Render thread, before endFrame(). The frame is drawn at this fraction
+    // of the size it is shown at, and gets scaled up when presented.
+    void setPresentScale(float scale) noexcept { writingScale = scale; }
+
+    // Message thread. Blits the most recently finished frame into area and
+    // fills whatever it doesn't cover (e.g. mid-resize) with black.
+    void drawTo(juce::Graphics& g, juce::Rectangle<int> area);
+
+    // Light below this (in stroke units) doesn't bloom, so fading trails stay crisp
+    static constexpr float bloomThreshold = 0.1f;
+
+    // A beam step longer than this many pixels is splatted at this many points
+    static constexpr int maxBeamSplats = 64;
+
+private:
+    void resize(int newWidth, int newHeight);
+    void addCapsule(juce::Point<float> a, juce::Point<float> b, float radius, juce::Colour colour) noexcept;
+    void addCapsuleRow(int y, int x0, int x1, float ax, float ay, float dx, float dy, float invLengthSq,
+                       float reach, float red, float green, float blue) noexcept;
+    void addStamp(juce::Point<float> centre, float radius, juce::Colour colour) noexcept;
+    void toneMap();
+    void buildBloom();
+    void upsampleBloomRow(int y) noexcept;
+
+    float* plane(int index) noexcept { return planeBase + (size_t)index * planeSize; }
+    float* bloomPlane(int index) noexcept { return bloomPlanes.data() + (size_t)index * bloomPlaneSize; }
+
+    int width = 0, height = 0, stride = 0;
+    size_t planeSize = 0;
+    std::vector<float> storage;      // R, G, B planes, rows padded for aligned loads
+    float* planeBase = nullptr;
+    juce::Rectangle<int> clip;
+    std::vector<float> toneRow;
+
+    // Density curve for this frame: light v becomes log2(1 + gain v) * norm,
+    // applied to a pixel's brightest channel and scaling all three alike
+    float densityGain = 0.0f, densityNorm = 1.0f;
+    std::vector<float> curveRow;
+
+    // Dot stamps, built on first use: stampPhases^2 positions per quantised
+    // diameter. Larger dots are drawn as capsules.
+    struct Stamp
+    {
+        int size = 0;           // side, in pixels; 0 until built
+        int offset = 0;         // of the top left pixel from the centre's pixel
+        std::vector<float> coverage;
+    };
+
+    static constexpr int stampPhases = 4;
+    static constexpr float maxStampDiameter = 32.0f;
+    std::vector<Stamp> stamps;
+
+    // Bloom, rebuilt every frame at 1/bloomFactor resolution. Planes carry
+    // bloomPad zeros on every side so the blur taps need no edge checks.
+    float bloomStrength = 0.0f, bloomRadius = 0.0f;
+    int bloomFactor = 0, bloomWidth = 0, bloomHeight = 0, bloomPad = 0, bloomStride = 0;
+    size_t bloomPlaneSize = 0;
+    std::vector<float> bloomPlanes;   // R, G, B, then one scratch plane
+    std::vector<float> bloomKernel;   // 2 * bloomPad + 1 taps
+    std::vector<int> upsampleIndex;   // per output column: left bloom column
+    std::vector<float> upsampleWeight;
+    std::vector<float> bloomLine;     // one vertically interpolated bloom row
+    std::vector<float> bloomRow;      // R, G, B glow of one output row
+
+    juce::Image writing;             // render thread only
+    juce::Image ready;               // under swapLock
+    juce::Image showing;             // message thread only
+    float writingScale = 1.0f, readyScale = 1.0f, showingScale = 1.0f; // present scale of each
+    bool readyIsNew = false;
+    juce::SpinLock swapLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SoftwareScopeCanvas)
+};
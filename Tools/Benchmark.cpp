@@ -0,0 +1,509 @@
+/*
+  ==============================================================================
+
+    Benchmarks for the audio and render paths, on synthetic signals.
+
+    Usage:
+      XYscopeBench [--suite fifo|process|render|analysis] [--filter text]
+                   [--format json|csv] [--out file] [--quick]
+
+    Suites:
+      fifo     pushSamples / pullSamples throughput of the scope ring
+      process  processBlock per colour mode, block size and sample rate
+      render   renderFrame on the software canvas per window size, render
+               mode, glow size, each mono shape and wave type, and sample
+               rate with and without a point budget
+      analysis one hop of FFT band analysis (ring read, window, FFT and
+               band sums) per sample rate and overlap
+
+    Every case runs on deterministic signals (mono sine, wide stereo noise
+    from a fixed seed, a Lissajous sweep), so results only differ by
+    machine and build. Results go to stdout, or --out, as JSON (default)
+    or CSV; per case: iterations, mean / median / p95 / min time per
+    iteration in ms, and items per second (samples, or frames).
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../Source/PluginProcessor.h"
+#include "../Source/ScopeRenderer.h"
+#include "../Source/AnalysisEngine.h"
+
+namespace
+{
+    //==============================================================================
+    enum class Signal { sine, noise, lissajous };
+
+    const char* getSignalName(Signal signal)
+    {
+        switch (signal)
+        {
+            case Signal::sine:      return "sine";
+            case Signal::noise:     return "noise";
+            case Signal::lissajous: return "lissajous";
+        }
+
+        return "";
+    }
+
+    constexpr Signal allSignals[] = { Signal::sine, Signal::noise, Signal::lissajous };
+
+    // Samples [start, start + numSamples) of a signal; the same range always
+    // gives the same samples
+    void generate(Signal signal, double sampleRate, juce::int64 start, float* left, float* right, int numSamples)
+    {
+        juce::Random random(start + 1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double t = (double)(start + i) / sampleRate;
+
+            switch (signal)
+            {
+                case Signal::sine:
+                    left[i] = right[i] = 0.5f * (float)std::sin(juce::MathConstants<double>::twoPi * 220.0 * t);
+                    break;
+
+                case Signal::noise:
+                    left[i] = random.nextFloat() - 0.5f;
+                    right[i] = random.nextFloat() - 0.5f;
+                    break;
+
+                case Signal::lissajous:
+                {
+                    // Frequency ratio drifting from 2:3 towards 3:4 and back every 8 s
+                    const double ratio = 1.5 - 0.25 * (0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * t / 8.0));
+                    left[i] = 0.6f * (float)std::sin(juce::MathConstants<double>::twoPi * 110.0 * t);
+                    right[i] = 0.6f * (float)std::sin(juce::MathConstants<double>::twoPi * 110.0 * ratio * t + 0.25 * juce::MathConstants<double>::pi);
+                    break;
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    struct Result
+    {
+        juce::String suite, name;
+        juce::NamedValueSet params;
+        int iterations = 0;
+        double meanMs = 0.0, medianMs = 0.0, p95Ms = 0.0, minMs = 0.0;
+        double itemsPerSecond = 0.0;
+    };
+
+    class Runner
+    {
+    public:
+        Runner(const juce::String& filterToUse, bool quickRun)
+            : filter(filterToUse), quick(quickRun)
+        {
+        }
+
+        bool wants(const juce::String& suite, const juce::String& name) const
+        {
+            return filter.isEmpty() || (suite + "/" + name).contains(filter);
+        }
+
+        int scaled(int iterations) const { return quick ? juce::jmax(4, iterations / 8) : iterations; }
+
+        // Times iterations calls of run after a few untimed ones; prepare runs
+        // untimed before each call. itemsPerIteration is what throughput counts.
+        void measure(const juce::String& suite, const juce::String& name, const juce::NamedValueSet& params,
+                     int iterations, double itemsPerIteration,
+                     const std::function<void()>& prepare, const std::function<void()>& run)
+        {
+            const int warmup = juce::jmax(2, iterations / 10);
+            std::vector<float> times;
+            times.reserve((size_t)iterations);
+
+            for (int i = 0; i < warmup + iterations; ++i)
+            {
+                if (prepare != nullptr)
+                    prepare();
+
+                const auto startMs = juce::Time::getMillisecondCounterHiRes();
+                run();
+                const auto ms = juce::Time::getMillisecondCounterHiRes() - startMs;
+
+                if (i >= warmup)
+                    times.push_back((float)ms);
+            }
+
+            Result r;
+            r.suite = suite;
+            r.name = name;
+            r.params = params;
+            r.iterations = iterations;
+
+            double total = 0.0;
+            for (auto t : times)
+                total += t;
+
+            r.meanMs = total / (double)iterations;
+            r.minMs = *std::min_element(times.begin(), times.end());
+            r.p95Ms = FrameProfiler::getPercentile(times, 0.95f);
+            r.medianMs = FrameProfiler::getPercentile(times, 0.5f);
+            r.itemsPerSecond = total > 0.0 ? itemsPerIteration * (double)iterations * 1000.0 / total : 0.0;
+
+            std::cerr << suite << "/" << name << ": " << juce::String(r.meanMs, 4) << " ms" << std::endl;
+            results.push_back(std::move(r));
+        }
+
+        void writeJson(juce::OutputStream& out) const
+        {
+            juce::Array<juce::var> cases;
+
+            for (const auto& r : results)
+            {
+                juce::DynamicObject::Ptr params = new juce::DynamicObject();
+
+                for (const auto& p : r.params)
+                    params->setProperty(p.name, p.value);
+
+                juce::DynamicObject::Ptr entry = new juce::DynamicObject();
+                entry->setProperty("suite", r.suite);
+                entry->setProperty("name", r.name);
+                entry->setProperty("params", params.get());
+                entry->setProperty("iterations", r.iterations);
+                entry->setProperty("mean_ms", r.meanMs);
+                entry->setProperty("median_ms", r.medianMs);
+                entry->setProperty("p95_ms", r.p95Ms);
+                entry->setProperty("min_ms", r.minMs);
+                entry->setProperty("items_per_s", r.itemsPerSecond);
+                cases.add(entry.get());
+            }
+
+            juce::DynamicObject::Ptr root = new juce::DynamicObject();
+            root->setProperty("cpu", juce::SystemStats::getCpuModel());
+            root->setProperty("cores", juce::SystemStats::getNumCpus());
+            root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+            root->setProperty("results", cases);
+
+            out << juce::JSON::toString(root.get()) << "\n";
+        }
+
+        void writeCsv(juce::OutputStream& out) const
+        {
+            out << "suite,name,params,iterations,mean_ms,median_ms,p95_ms,min_ms,items_per_s\n";
+
+            for (const auto& r : results)
+            {
+                juce::StringArray params;
+
+                for (const auto& p : r.params)
+                    params.add(p.name.toString() + "=" + p.value.toString());
+
+                out << r.suite << "," << r.name << "," << params.joinIntoString(";") << "," << r.iterations << ","
+                    << juce::String(r.meanMs, 5) << "," << juce::String(r.medianMs, 5) << ","
+                    << juce::String(r.p95Ms, 5) << "," << juce::String(r.minMs, 5) << ","
+                    << juce::String(r.itemsPerSecond, 1) << "\n";
+            }
+        }
+
+    private:
+        const juce::String filter;
+        const bool quick;
+        std::vector<Result> results;
+    };
+
+    //==============================================================================
+    void setParameter(XYscopeAudioProcessor& processor, const juce::String& id, float value)
+    {
+        auto* param = processor.apvts.getParameter(id);
+        jassert(param != nullptr);
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    // Scope ring throughput, without any processing around it
+    void runFifoSuite(Runner& runner)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int pushSize = 512;
+        constexpr int pullSize = 4096;
+
+        XYscopeAudioProcessor processor;
+        processor.prepareToPlay(sampleRate, pushSize);
+        processor.attachScopeViewer();
+
+        std::vector<std::vector<float>> storage((size_t)XYscopeAudioProcessor::numScopeChannels, std::vector<float>(pullSize));
+        float* channels[XYscopeAudioProcessor::numScopeChannels] = {};
+
+        // Left, right and the band envelopes, as processBlock pushes them for one pair
+        for (int c = 0; c <= XYscopeAudioProcessor::highChannel; ++c)
+            channels[c] = storage[(size_t)c].data();
+
+        for (auto signal : allSignals)
+        {
+            generate(signal, sampleRate, 0, channels[0], channels[1], pullSize);
+
+            juce::NamedValueSet params;
+            params.set("signal", getSignalName(signal));
+            params.set("block", pushSize);
+
+            const auto name = juce::String("push/") + getSignalName(signal);
+
+            if (runner.wants("fifo", name))
+                runner.measure("fifo", name, params, runner.scaled(20000), pushSize, nullptr,
+                               [&] { processor.pushSamples(channels, pushSize); });
+
+            // One frame's worth pushed, then pulled the way the renderer does
+            params.set("block", pullSize);
+
+            if (runner.wants("fifo", "pull/" + juce::String(getSignalName(signal))))
+                runner.measure("fifo", "pull/" + juce::String(getSignalName(signal)), params, runner.scaled(2000), pullSize,
+                               [&] { processor.pushSamples(channels, pullSize); },
+                               [&] { processor.pullSamples(channels, pullSize); });
+        }
+
+        processor.detachScopeViewer();
+        processor.releaseResources();
+    }
+
+    // processBlock with a viewer attached, per colour mode, block size and rate
+    void runProcessSuite(Runner& runner)
+    {
+        static const char* const colourModes[] = { "energy", "fft", "crossover" };
+
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        {
+            for (int blockSize : { 64, 256, 512, 2048 })
+            {
+                for (int mode = 0; mode < 3; ++mode)
+                {
+                    const auto name = juce::String(colourModes[mode]) + "/" + juce::String((int)sampleRate) + "/" + juce::String(blockSize);
+
+                    if (! runner.wants("process", name))
+                        continue;
+
+                    XYscopeAudioProcessor processor;
+                    setParameter(processor, "colourMode", (float)mode);
+                    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                    processor.prepareToPlay(sampleRate, blockSize);
+                    processor.attachScopeViewer();
+
+                    const int numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+                    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+                    juce::MidiBuffer midi;
+                    juce::int64 position = 0;
+
+                    juce::NamedValueSet params;
+                    params.set("colourMode", colourModes[mode]);
+                    params.set("sampleRate", sampleRate);
+                    params.set("block", blockSize);
+                    params.set("signal", "noise");
+
+                    // About two seconds of audio per case
+                    const int iterations = runner.scaled(juce::jmax(64, (int)(2.0 * sampleRate) / blockSize));
+
+                    runner.measure("process", name, params, iterations, blockSize,
+                                   [&]
+                                   {
+                                       generate(Signal::noise, sampleRate, position, buffer.getWritePointer(0),
+                                                buffer.getWritePointer(1), blockSize);
+                                       position += blockSize;
+                                   },
+                                   [&] { processor.processBlock(buffer, midi); });
+
+                    processor.detachScopeViewer();
+                    processor.releaseResources();
+                }
+            }
+        }
+    }
+
+    // AnalysisEngine's work per hop, on its own: each timed update() finds one
+    // hop of new samples in the ring and analyses exactly one window
+    void runAnalysisSuite(Runner& runner)
+    {
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        {
+            for (float overlap : { 0.0f, 0.5f, 0.75f, 0.875f })
+            {
+                const auto name = juce::String((int)sampleRate) + "/" + juce::String(juce::roundToInt(overlap * 100.0f));
+
+                if (! runner.wants("analysis", name))
+                    continue;
+
+                ScopeRing ring(2, 1 << 15);
+                AnalysisEngine engine;
+
+                // Offline, so the worker never runs and update() does the work here
+                engine.setOffline(true);
+                engine.prepare(sampleRate);
+                engine.setOverlap(overlap);
+                engine.setSource(&ring);
+                engine.setActive(true);
+
+                const int hopSize = engine.getHopSize();
+                std::vector<float> left((size_t)(8 * hopSize)), right(left.size());
+                float* channels[] = { left.data(), right.data() };
+                juce::int64 position = 0;
+
+                // A full window's history first, so every timed hop is a steady-state one
+                generate(Signal::noise, sampleRate, position, left.data(), right.data(), (int)left.size());
+                ring.write(channels, (int)left.size());
+                position += (juce::int64)left.size();
+                engine.update();
+
+                juce::NamedValueSet params;
+                params.set("sampleRate", sampleRate);
+                params.set("overlap", overlap);
+                params.set("hop", hopSize);
+                params.set("signal", "noise");
+
+                // About two seconds of audio per case
+                const int iterations = runner.scaled(juce::jmax(64, (int)(2.0 * sampleRate) / hopSize));
+
+                runner.measure("analysis", name, params, iterations, hopSize,
+                               [&]
+                               {
+                                   generate(Signal::noise, sampleRate, position, left.data(), right.data(), hopSize);
+                                   ring.write(channels, hopSize);
+                                   position += hopSize;
+                               },
+                               [&] { engine.update(); });
+
+                engine.setSource(nullptr);
+            }
+        }
+    }
+
+    // One renderFrame case: a fresh renderer fed at 60 frames per second
+    void runRenderCase(Runner& runner, const juce::String& name, Signal signal, int width, int height,
+                       const std::vector<std::pair<juce::String, float>>& settings,
+                       double sampleRate = 48000.0, int pointBudget = XYscopeAudioProcessor::defaultPointBudget)
+    {
+        if (! runner.wants("render", name))
+            return;
+
+        constexpr double fps = 60.0;
+        const int blockSize = juce::roundToInt(sampleRate / fps); // one frame's worth
+
+        XYscopeAudioProcessor processor;
+
+        juce::NamedValueSet params;
+        params.set("signal", getSignalName(signal));
+        params.set("width", width);
+        params.set("height", height);
+        params.set("sampleRate", sampleRate);
+        params.set("points", pointBudget);
+
+        for (const auto& setting : settings)
+        {
+            setParameter(processor, setting.first, setting.second);
+            params.set(setting.first, setting.second);
+        }
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.attachScopeViewer();
+
+        const int numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 position = 0;
+
+        {
+            // Full quality every frame, with trails decaying at the nominal rate
+            ScopeRenderer renderer(processor);
+            renderer.setFrameBudgetMs(0.0);
+            renderer.setFixedFrameInterval(1000.0 / fps);
+            renderer.setPointBudget(pointBudget);
+
+            runner.measure("render", name, params, runner.scaled(240), 1.0,
+                           [&]
+                           {
+                               generate(signal, sampleRate, position, buffer.getWritePointer(0),
+                                        buffer.getWritePointer(1), blockSize);
+                               position += blockSize;
+                               processor.processBlock(buffer, midi);
+                           },
+                           [&] { renderer.renderFrame(width, height); });
+        }
+
+        processor.detachScopeViewer();
+        processor.releaseResources();
+    }
+
+    void runRenderSuite(Runner& runner)
+    {
+        const std::pair<int, int> sizes[] = { { 400, 400 }, { 800, 800 }, { 1600, 1200 } };
+
+        static const char* const renderModes[] = { "line", "particle", "phosphor" };
+
+        // Window size x render mode x glow size, per signal
+        for (auto signal : allSignals)
+            for (const auto& size : sizes)
+                for (int mode = 0; mode < 3; ++mode)
+                    for (float glowSize : { 2.0f, 5.0f, 10.0f })
+                        runRenderCase(runner,
+                                      juce::String(renderModes[mode]) + "/" + getSignalName(signal) + "/"
+                                          + juce::String(size.first) + "x" + juce::String(size.second) + "/glow" + juce::String((int)glowSize),
+                                      signal, size.first, size.second,
+                                      { { "renderMode", (float)mode }, { "glowSize", glowSize } });
+
+        // Each mono shape and wave type, where the pattern is fully visible
+        static const char* const shapes[] = { "circle", "star", "square", "spiral" };
+        static const char* const waves[] = { "sine", "triangle", "square", "sawtooth" };
+
+        for (int shape = 0; shape < 4; ++shape)
+            for (int wave = 0; wave < 4; ++wave)
+                runRenderCase(runner, juce::String("pattern/") + shapes[shape] + "/" + waves[wave], Signal::sine, 800, 800,
+                              { { "monoAmount", 1.0f }, { "monoShape", (float)shape }, { "waveType", (float)wave } });
+
+        // Sample rate x point budget: with a budget, cost shouldn't follow the rate
+        for (double sampleRate : { 44100.0, 96000.0, 192000.0 })
+            for (int points : { 0, 1024 })
+                runRenderCase(runner, "rate/" + juce::String((int)sampleRate) + "/points" + juce::String(points),
+                              Signal::lissajous, 800, 800, {}, sampleRate, points);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInit;
+    const juce::ArgumentList args(argc, argv);
+
+    const auto suite = args.getValueForOption("--suite");
+    const auto format = args.getValueForOption("--format");
+    const auto outPath = args.getValueForOption("--out");
+
+    Runner runner(args.getValueForOption("--filter"), args.containsOption("--quick"));
+
+    if (suite.isEmpty() || suite == "fifo")     runFifoSuite(runner);
+    if (suite.isEmpty() || suite == "process")  runProcessSuite(runner);
+    if (suite.isEmpty() || suite == "render")   runRenderSuite(runner);
+    if (suite.isEmpty() || suite == "analysis") runAnalysisSuite(runner);
+
+    std::unique_ptr<juce::OutputStream> out;
+
+    if (outPath.isNotEmpty())
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(outPath);
+        file.deleteFile();
+        out = file.createOutputStream();
+
+        if (out == nullptr)
+        {
+            std::cerr << "can't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        out = std::make_unique<juce::MemoryOutputStream>();
+    }
+
+    if (format == "csv")
+        runner.writeCsv(*out);
+    else
+        runner.writeJson(*out);
+
+    if (auto* memory = dynamic_cast<juce::MemoryOutputStream*>(out.get()))
+        std::cout << memory->toString();
+
+    return 0;
+}
@@ -0,0 +1,265 @@
+/*
+  ==============================================================================
+
+    Offline renderer: streams an audio file through the plugin and writes the
+    scope as a numbered frame sequence, without a host or a window.
+
+    Usage:
+      XYscopeRender <audio file> <output folder> [options]
+
+      --width N, --height N    frame size (default 1280 x 720)
+      --fps N                  frames per second of output (default 60)
+      --block N                samples per processBlock call (default 512)
+      --points N               points per frame each trace is resampled to
+                               (default 0: every sample as it comes)
+      --format png|rgba        numbered PNGs (default), or one raw RGBA stream
+                               (frames.rgba, for ffmpeg -f rawvideo)
+      --param id=value         set a plugin parameter, in its own units;
+                               may be repeated
+
+    Output depends only on the audio, the options and the parameters: audio
+    goes through processBlock in fixed blocks, trails decay by the fixed
+    frame interval rather than the clock, the quality governor is off, and
+    the FFT colour bands are analysed on this thread before each frame
+    rather than by the analysis worker.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../Source/PluginProcessor.h"
+#include "../Source/ScopeRenderer.h"
+
+namespace
+{
+    struct Options
+    {
+        juce::File input, output;
+        int width = 1280, height = 720, blockSize = 512;
+        int points = XYscopeAudioProcessor::defaultPointBudget;
+        double fps = 60.0;
+        bool raw = false;
+        juce::StringPairArray params;
+    };
+
+    int fail(const juce::String& message)
+    {
+        std::cerr << message << std::endl;
+        return 1;
+    }
+
+    bool parseOptions(const juce::ArgumentList& args, Options& options, juce::String& error)
+    {
+        if (args.size() < 2)
+        {
+            error = "usage: " + args.executableName + " <audio file> <output folder> [--width N] [--height N]"
+                    " [--fps N] [--block N] [--points N] [--format png|rgba] [--param id=value ...]";
+            return false;
+        }
+
+        options.input = args[0].resolveAsFile();
+        options.output = args[1].resolveAsFile();
+
+        for (int i = 2; i < args.size(); ++i)
+        {
+            const auto name = args[i].text;
+            const auto value = i + 1 < args.size() ? args[i + 1].text : juce::String();
+
+            if (value.isEmpty())
+            {
+                error = "missing value for " + name;
+                return false;
+            }
+
+            if (name == "--width")        options.width = value.getIntValue();
+            else if (name == "--height")  options.height = value.getIntValue();
+            else if (name == "--fps")     options.fps = value.getDoubleValue();
+            else if (name == "--block")   options.blockSize = value.getIntValue();
+            else if (name == "--points")  options.points = value.getIntValue();
+            else if (name == "--format")  options.raw = value == "rgba";
+            else if (name == "--param")   options.params.set(value.upToFirstOccurrenceOf("=", false, false),
+                                                             value.fromFirstOccurrenceOf("=", false, false));
+            else
+            {
+                error = "unknown option " + name;
+                return false;
+            }
+
+            ++i;
+        }
+
+        if (options.width < 16 || options.height < 16 || options.fps <= 0.0 || options.blockSize < 16
+            || ! juce::isPositiveAndNotGreaterThan(options.points, ScopeRenderer::maxFramePoints))
+        {
+            error = "frame size, frame rate, block size or point budget out of range";
+            return false;
+        }
+
+        return true;
+    }
+
+    // Unpremultiplied R, G, B, A bytes, row by row
+    void appendRGBA(const juce::Image& image, juce::MemoryBlock& dest)
+    {
+        const juce::Image::BitmapData pixels(image, juce::Image::BitmapData::readOnly);
+        const auto offset = dest.getSize();
+        dest.setSize(offset + (size_t)(image.getWidth() * image.getHeight() * 4));
+
+        auto* out = static_cast<juce::uint8*>(dest.getData()) + offset;
+
+        for (int y = 0; y < image.getHeight(); ++y)
+        {
+            for (int x = 0; x < image.getWidth(); ++x)
+            {
+                const auto colour = pixels.getPixelColour(x, y);
+                *out++ = colour.getRed();
+                *out++ = colour.getGreen();
+                *out++ = colour.getBlue();
+                *out++ = colour.getAlpha();
+            }
+        }
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInit;
+
+    Options options;
+    juce::String error;
+
+    if (! parseOptions(juce::ArgumentList(argc, argv), options, error))
+        return fail(error);
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(options.input));
+
+    if (reader == nullptr)
+        return fail("can't read " + options.input.getFullPathName());
+
+    if (options.output.createDirectory().failed())
+        return fail("can't create " + options.output.getFullPathName());
+
+    XYscopeAudioProcessor processor;
+
+    for (auto& id : options.params.getAllKeys())
+    {
+        auto* param = processor.apvts.getParameter(id);
+
+        if (param == nullptr)
+            return fail("no parameter called " + id);
+
+        param->setValueNotifyingHost(param->convertTo0to1(options.params[id].getFloatValue()));
+    }
+
+    const double sampleRate = reader->sampleRate;
+    const int numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+
+    processor.setRateAndBufferSizeDetails(sampleRate, options.blockSize);
+    processor.prepareToPlay(sampleRate, options.blockSize);
+    processor.setOfflineAnalysis(true);
+    processor.attachScopeViewer();
+
+    ScopeRenderer renderer(processor);
+    renderer.setFrameBudgetMs(0.0);
+    renderer.setFixedFrameInterval(1000.0 / options.fps);
+    renderer.setPointBudget(options.points);
+
+    const auto totalSamples = reader->lengthInSamples;
+    const auto numFrames = (juce::int64)std::ceil((double)totalSamples * options.fps / sampleRate);
+
+    juce::AudioBuffer<float> block(numChannels, options.blockSize);
+    juce::MidiBuffer midi;
+    juce::int64 processed = 0;
+
+    // Rendering a frame needs the trails of the one before, so frames are
+    // rendered in order; encoding and writing them runs in parallel
+    juce::ThreadPool encoders(juce::jmax(1, juce::SystemStats::getNumCpus() - 1));
+    const int maxPendingFrames = 2 * encoders.getNumThreads();
+
+    std::unique_ptr<juce::FileOutputStream> rawStream;
+
+    if (options.raw)
+    {
+        const auto rawFile = options.output.getChildFile("frames.rgba");
+        rawFile.deleteFile();
+        rawStream = rawFile.createOutputStream();
+
+        if (rawStream == nullptr)
+            return fail("can't write " + rawFile.getFullPathName());
+    }
+
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    for (juce::int64 frame = 0; frame < numFrames; ++frame)
+    {
+        // All the audio up to the end of this frame, in whole blocks
+        const auto frameEnd = juce::jmin(totalSamples, (juce::int64)((double)(frame + 1) * sampleRate / options.fps));
+
+        while (processed < frameEnd)
+        {
+            const int numSamples = (int)juce::jmin((juce::int64)options.blockSize, totalSamples - processed);
+            block.setSize(numChannels, numSamples, false, false, true);
+            block.clear();
+
+            reader->read(&block, 0, numSamples, processed, true, true);
+
+            // Mono files feed both sides
+            if (reader->numChannels == 1)
+                for (int ch = 1; ch < numChannels; ++ch)
+                    block.copyFrom(ch, 0, block, 0, 0, numSamples);
+
+            processor.processBlock(block, midi);
+            processed += numSamples;
+        }
+
+        processor.updateAnalysis();
+        renderer.renderFrame(options.width, options.height);
+
+        juce::Image image(juce::Image::ARGB, options.width, options.height, true, juce::SoftwareImageType());
+
+        {
+            juce::Graphics g(image);
+            renderer.drawTo(g, image.getBounds());
+        }
+
+        if (rawStream != nullptr)
+        {
+            juce::MemoryBlock pixels;
+            appendRGBA(image, pixels);
+            rawStream->write(pixels.getData(), pixels.getSize());
+            continue;
+        }
+
+        while (encoders.getNumJobs() >= maxPendingFrames)
+            juce::Thread::sleep(1);
+
+        const auto file = options.output.getChildFile("frame_" + juce::String(frame).paddedLeft('0', 6) + ".png");
+
+        encoders.addJob([image, file]
+            {
+                file.deleteFile();
+                juce::FileOutputStream out(file);
+                juce::PNGImageFormat png;
+
+                if (! out.openedOk() || ! png.writeImageToStream(image, out))
+                    std::cerr << "can't write " << file.getFullPathName() << std::endl;
+            });
+    }
+
+    while (encoders.getNumJobs() > 0)
+        juce::Thread::sleep(1);
+
+    const auto seconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    std::cout << numFrames << " frames of " << options.width << " x " << options.height << " in "
+              << juce::String(seconds, 2) << " s (" << juce::String((double)numFrames / juce::jmax(seconds, 0.001), 1)
+              << " fps)" << std::endl;
+
+    processor.detachScopeViewer();
+    processor.releaseResources();
+    return 0;
+}
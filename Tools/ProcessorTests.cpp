@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    Checks of the processor's audio path that need no host or window.
+
+    Usage:
+      XYscopeTests
+
+    Prints each failed check and exits with 1 if there were any, else 0.
+    Run by ctest.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../Source/PluginProcessor.h"
+
+namespace
+{
+    int numFailures = 0;
+
+    void expect(bool condition, const juce::String& what)
+    {
+        if (! condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++numFailures;
+        }
+    }
+
+    void setParameter(XYscopeAudioProcessor& processor, const juce::String& id, float value)
+    {
+        auto* param = processor.apvts.getParameter(id);
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    // A few blocks of a loud stereo sine, enough to count as signal
+    void processSine(XYscopeAudioProcessor& processor, int numBlocks, int blockSize)
+    {
+        juce::AudioBuffer<float> block(2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto t = (double)(b * blockSize + i) / 48000.0;
+                const auto value = 0.5f * (float)std::sin(juce::MathConstants<double>::twoPi * 220.0 * t);
+                block.setSample(0, i, value);
+                block.setSample(1, i, value);
+            }
+
+            processor.processBlock(block, midi);
+        }
+    }
+
+    //==============================================================================
+    // With no viewer attached processBlock must do no scope work at all: no
+    // ring, nothing pushed, no signal noted, and the FFT analysis left idle
+    // even with FFT colour selected.
+    void testNoViewerDoesNoScopeWork()
+    {
+        XYscopeAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(48000.0, 512);
+        processor.prepareToPlay(48000.0, 512);
+        setParameter(processor, "colourMode", (float)XYscopeAudioProcessor::fftColour);
+
+        const auto stream = processor.getScopeStream();
+
+        processSine(processor, 16, 512);
+
+        expect(! processor.isScopeAttached(), "no viewer: nothing attached");
+        expect(stream->getRing() == nullptr, "no viewer: no ring allocated");
+        expect(stream->getSignalCount() == 0, "no viewer: no signal noted");
+        expect(processor.getFifoStats().pushedSamples == 0, "no viewer: nothing pushed");
+        expect(! processor.isAnalysisActive(), "no viewer: analysis inactive");
+
+        // The same processor does all of it once watched, so the checks
+        // above can fail
+        processor.attachScopeViewer();
+        processSine(processor, 16, 512);
+
+        expect(stream->getRing() != nullptr, "viewer: ring allocated");
+        expect(stream->getSignalCount() > 0, "viewer: signal noted");
+        expect(processor.getFifoStats().pushedSamples > 0, "viewer: samples pushed");
+        expect(processor.isAnalysisActive(), "viewer: analysis active");
+
+        // And stops again once the last viewer goes
+        processor.detachScopeViewer();
+        const auto signalCount = stream->getSignalCount();
+        const auto pushedSamples = processor.getFifoStats().pushedSamples;
+
+        processSine(processor, 16, 512);
+
+        expect(stream->getRing() == nullptr, "detached: ring released");
+        expect(stream->getSignalCount() == signalCount, "detached: no signal noted");
+        expect(processor.getFifoStats().pushedSamples == pushedSamples, "detached: nothing pushed");
+        expect(! processor.isAnalysisActive(), "detached: analysis inactive");
+
+        processor.releaseResources();
+    }
+}
+
+//==============================================================================
+int main()
+{
+    const juce::ScopedJuceInitialiser_GUI juceInit;
+
+    testNoViewerDoesNoScopeWork();
+
+    std::cout << (numFailures == 0 ? "all checks passed" : juce::String(numFailures) + " checks failed") << std::endl;
+    return numFailures == 0 ? 0 : 1;
+}